@@ -0,0 +1,34 @@
+// Cross-origin isolation for hosts that can't send COOP/COEP headers (GitHub Pages).
+//
+// Registered by index.html. Every response served under the page's scope gets the
+// headers added here, so the page becomes crossOriginIsolated after one reload and can
+// share memory with its workers: the execution worker's stop flag needs
+// SharedArrayBuffer. All playground assets are same-origin, so `require-corp` blocks
+// nothing.
+
+self.addEventListener('install', () => self.skipWaiting());
+
+self.addEventListener('activate', (event) => event.waitUntil(self.clients.claim()));
+
+self.addEventListener('fetch', (event) => {
+  const { request } = event;
+  // Throws when forwarded for a cross-origin request; leave it to the browser
+  if (request.cache === 'only-if-cached' && request.mode !== 'same-origin') return;
+
+  event.respondWith(
+    fetch(request).then((response) => {
+      // Opaque responses can't be rewritten, and need no CORP from this origin
+      if (response.status === 0) return response;
+
+      const headers = new Headers(response.headers);
+      headers.set('Cross-Origin-Opener-Policy', 'same-origin');
+      headers.set('Cross-Origin-Embedder-Policy', 'require-corp');
+      headers.set('Cross-Origin-Resource-Policy', 'same-origin');
+      return new Response(response.body, {
+        status: response.status,
+        statusText: response.statusText,
+        headers,
+      });
+    })
+  );
+});
@@ -11,6 +11,38 @@ export const defaultSettings: PlaygroundSettings = {
   compilerRemarks: false,
 };
 
+// Wall-clock budget for a single run; the VM interrupt aborts the script past this
+export const EXECUTION_TIME_LIMIT_MS = 30000;
+
+// Memory one run may allocate; past this the script fails with an out of memory error
+export const EXECUTION_MEMORY_LIMIT_BYTES = 256 * 1024 * 1024;
+
+// Print streaming: records are delivered at least this often while a script runs
+export const PRINT_FLUSH_INTERVAL_MS = 50;
+// Buffered print bytes that force a flush from the VM
+export const PRINT_FLUSH_BYTES = 64 * 1024;
+// Total print output kept per run; later prints are dropped
+export const MAX_OUTPUT_BYTES = 16 * 1024 * 1024;
+
+// Budgets for printed values; deeper or wider tables are expanded on demand
+export const PRINT_MAX_DEPTH = 8;
+export const PRINT_MAX_WIDTH = 500;
+export const PRINT_MAX_BYTES = 256 * 1024;
+
+// Minimum time between profiler samples for profiled runs
+export const PROFILE_SAMPLE_INTERVAL_US = 500;
+
+// Default measured and warmup runs for benchmarks
+export const BENCHMARK_ITERATIONS = 100;
+export const BENCHMARK_WARMUP = 10;
+
+// Budget for typechecking a single module in the analysis worker
+export const ANALYSIS_CHECK_TIME_LIMIT_MS = 5000;
+// Type arena budget for the analysis worker; only the active file keeps its full type graph
+export const ANALYSIS_MEMORY_BUDGET_BYTES = 64 * 1024 * 1024;
+// Most completions per request; the analysis worker filters and ranks, the editor shows them as is
+export const AUTOCOMPLETE_LIMIT = 50;
+
 // Key for localStorage persistence of settings
 export const STORAGE_KEY = 'luau-playground-settings';
 
@@ -5,16 +5,96 @@
  * by integrating with the Luau WASM module.
  */
 
-import { EditorView, hoverTooltip, ViewPlugin } from '@codemirror/view';
-import type { Tooltip } from '@codemirror/view';
+import { EditorView, hoverTooltip, showTooltip, ViewPlugin } from '@codemirror/view';
+import type { Tooltip, ViewUpdate } from '@codemirror/view';
 import { linter } from '@codemirror/lint';
 import type { Diagnostic } from '@codemirror/lint';
 import { autocompletion, startCompletion, type CompletionContext } from '@codemirror/autocomplete';
 import type { CompletionResult, Completion } from '@codemirror/autocomplete';
-import type { Extension } from '@codemirror/state';
-import { getDiagnostics, getAutocomplete, getHover, getAvailableModules, type LuauDiagnostic, type LuauCompletion } from '$lib/luau/wasm';
+import { StateEffect, StateField } from '@codemirror/state';
+import type { Extension, Text } from '@codemirror/state';
+import { get } from 'svelte/store';
+import {
+  getDiagnostics,
+  getAutocomplete,
+  resolveCompletion,
+  getHover,
+  getSignatureHelp,
+  getAvailableModules,
+  applyDocumentEdits,
+  type LuauDiagnostic,
+  type LuauCompletion,
+  type DocumentEdit,
+  type SignatureResult,
+} from '$lib/luau/wasm';
+import { activeFile } from '$lib/stores/playground';
 import { highlightLuauHtml } from './textmate';
 
+// ============================================================================
+// Positions
+// ============================================================================
+
+// Luau columns are UTF-8 byte offsets; CodeMirror columns are UTF-16 code units
+const ASCII = /^[\x00-\x7f]*$/;
+
+function toByteColumn(lineText: string, col: number): number {
+  const prefix = lineText.slice(0, col);
+  if (ASCII.test(prefix)) return prefix.length;
+  return new TextEncoder().encode(prefix).length;
+}
+
+function fromByteColumn(lineText: string, byteCol: number): number {
+  if (ASCII.test(lineText)) return Math.min(byteCol, lineText.length);
+  
+  let bytes = 0;
+  let col = 0;
+  for (const ch of lineText) {
+    const code = ch.codePointAt(0)!;
+    bytes += code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+    if (bytes > byteCol) break;
+    col += ch.length;
+  }
+  return col;
+}
+
+/** 0-based line and byte column of a document offset */
+function toLuauPosition(doc: Text, pos: number): { line: number; col: number } {
+  const line = doc.lineAt(pos);
+  return { line: line.number - 1, col: toByteColumn(line.text, pos - line.from) };
+}
+
+// ============================================================================
+// Document Sync
+// ============================================================================
+
+/**
+ * Forward each change to the analysis worker as a range edit, so queries
+ * don't have to resubmit the whole document.
+ */
+function createDocumentSync(): Extension {
+  return EditorView.updateListener.of((update) => {
+    if (!update.docChanged) return;
+    
+    // Ranges are reported against the old document in ascending order;
+    // applying them back to front keeps the earlier ranges valid
+    const edits: DocumentEdit[] = [];
+    update.changes.iterChanges((fromA, toA, _fromB, _toB, inserted) => {
+      const start = toLuauPosition(update.startState.doc, fromA);
+      const end = toLuauPosition(update.startState.doc, toA);
+      edits.push({
+        startLine: start.line,
+        startCol: start.col,
+        endLine: end.line,
+        endCol: end.col,
+        text: inserted.toString(),
+      });
+    });
+    edits.reverse();
+    
+    applyDocumentEdits(get(activeFile), edits, update.state.doc.toString());
+  });
+}
+
 // ============================================================================
 // Diagnostics (Linter)
 // ============================================================================
@@ -24,18 +104,16 @@ import { highlightLuauHtml } from './textmate';
  */
 function createLuauLinter() {
   return linter(async (view): Promise<Diagnostic[]> => {
-    const code = view.state.doc.toString();
-    
     try {
-      const { diagnostics: luauDiagnostics } = await getDiagnostics(code);
+      const { diagnostics: luauDiagnostics } = await getDiagnostics(get(activeFile));
       
       return luauDiagnostics.map((d: LuauDiagnostic) => {
         // Convert line/column to document positions
-        const startLine = view.state.doc.line(d.startLine + 1);
-        const endLine = view.state.doc.line(d.endLine + 1);
+        const startLine = view.state.doc.line(Math.min(d.startLine + 1, view.state.doc.lines));
+        const endLine = view.state.doc.line(Math.min(d.endLine + 1, view.state.doc.lines));
         
-        const from = startLine.from + Math.min(d.startCol, startLine.length);
-        const to = endLine.from + Math.min(d.endCol, endLine.length);
+        const from = startLine.from + fromByteColumn(startLine.text, d.startCol);
+        const to = endLine.from + fromByteColumn(endLine.text, d.endCol);
         
         return {
           from: Math.max(0, from),
@@ -133,6 +211,32 @@ async function requireCompletionSource(context: CompletionContext): Promise<Comp
   }
 }
 
+/**
+ * Info panel of the selected completion, fetched only when an item is selected
+ * (like LSP completionItem/resolve).
+ */
+async function resolveCompletionInfo(completion: Completion): Promise<Node | null> {
+  const details = await resolveCompletion(completion.label);
+  const documentation = details?.documentation;
+  if (!documentation) {
+    return null;
+  }
+  
+  const dom = document.createElement('code');
+  dom.style.cssText = `
+    font-family: var(--font-mono);
+    white-space: pre-wrap;
+  `;
+  
+  const codeBlockMatch = documentation.match(/```luau\n([\s\S]*?)\n```/);
+  if (codeBlockMatch) {
+    dom.innerHTML = await highlightLuauHtml(codeBlockMatch[1]);
+  } else {
+    dom.textContent = documentation;
+  }
+  return dom;
+}
+
 /**
  * Create an autocomplete source that fetches completions from the WASM module.
  */
@@ -159,16 +263,11 @@ async function luauCompletionSource(context: CompletionContext): Promise<Complet
     return null;
   }
   
-  const code = context.state.doc.toString();
   const pos = context.pos;
-  
-  // Convert position to line/column
-  const line = context.state.doc.lineAt(pos);
-  const lineNum = line.number - 1; // 0-indexed
-  const col = pos - line.from;
+  const { line, col } = toLuauPosition(context.state.doc, pos);
   
   try {
-    const items = await getAutocomplete(code, lineNum, col);
+    const items = await getAutocomplete(get(activeFile), line, col, word?.text ?? '');
     
     if (items.length === 0) {
       return null;
@@ -179,6 +278,7 @@ async function luauCompletionSource(context: CompletionContext): Promise<Complet
       type: mapCompletionKind(item.kind),
       detail: item.detail,
       deprecated: item.deprecated,
+      info: resolveCompletionInfo,
     }));
     
     // Calculate the correct 'from' position
@@ -186,10 +286,12 @@ async function luauCompletionSource(context: CompletionContext): Promise<Complet
     // Otherwise, start from the beginning of the word being typed
     const from = word ? word.from : pos;
     
+    // Items come filtered, ranked and truncated for this prefix, so they are shown as is
+    // and requested again on the next keystroke instead of being refiltered here
     return {
       from,
       options: completions,
-      validFor: /^[\w]*$/,
+      filter: false,
     };
   } catch (error) {
     console.error('[Luau Autocomplete] Error:', error);
@@ -237,15 +339,10 @@ function createLuauAutocomplete(): Extension[] {
  */
 function createLuauHover() {
   return hoverTooltip(async (view, pos, side): Promise<Tooltip | null> => {
-    const code = view.state.doc.toString();
-    
-    // Convert position to line/column
-    const line = view.state.doc.lineAt(pos);
-    const lineNum = line.number - 1; // 0-indexed
-    const col = pos - line.from;
+    const { line, col } = toLuauPosition(view.state.doc, pos);
     
     try {
-      const content = await getHover(code, lineNum, col);
+      const content = await getHover(get(activeFile), line, col);
       
       if (!content) {
         return null;
@@ -317,6 +414,118 @@ function createLuauHover() {
   });
 }
 
+// ============================================================================
+// Signature Help
+// ============================================================================
+
+const setSignatureTooltip = StateEffect.define<Tooltip | null>();
+
+const signatureTooltipField = StateField.define<Tooltip | null>({
+  create: () => null,
+  update(tooltip, tr) {
+    for (const effect of tr.effects) {
+      if (effect.is(setSignatureTooltip)) return effect.value;
+    }
+    return tooltip && tr.docChanged ? { ...tooltip, pos: tr.changes.mapPos(tooltip.pos) } : tooltip;
+  },
+  provide: (field) => showTooltip.from(field),
+});
+
+/**
+ * Render the active signature with the argument under the cursor in bold.
+ */
+function renderSignature(result: SignatureResult): HTMLElement {
+  const signature = result.signatures[result.activeSignature];
+  const dom = document.createElement('div');
+  dom.className = 'cm-luau-signature';
+  dom.style.cssText = `
+    padding: 6px 10px;
+    background: var(--bg-secondary);
+    color: var(--text-primary);
+    font-size: 13px;
+    font-family: var(--font-mono);
+    white-space: pre-wrap;
+    max-width: 450px;
+  `;
+  
+  // Parameters appear in order after the opening parenthesis
+  const label = signature.label;
+  const parameter = signature.parameters?.[result.activeParameter]
+    ?? (signature.parameters?.at(-1)?.label.startsWith('...') ? signature.parameters.at(-1) : undefined);
+  let start = -1;
+  if (parameter) {
+    let from = label.indexOf('(') + 1;
+    for (const p of signature.parameters ?? []) {
+      const index = label.indexOf(p.label, from);
+      if (p === parameter) {
+        start = index;
+        break;
+      }
+      from = index + p.label.length;
+    }
+  }
+  
+  if (parameter && start >= 0) {
+    const active = document.createElement('strong');
+    active.textContent = parameter.label;
+    dom.append(label.slice(0, start), active, label.slice(start + parameter.label.length));
+  } else {
+    dom.textContent = label;
+  }
+  
+  if (result.signatures.length > 1) {
+    const overloads = document.createElement('span');
+    overloads.style.cssText = 'color: var(--text-secondary); margin-left: 8px;';
+    overloads.textContent = `(${result.activeSignature + 1}/${result.signatures.length})`;
+    dom.appendChild(overloads);
+  }
+  
+  return dom;
+}
+
+/**
+ * Show the signature of the enclosing call when '(' or ',' is typed, and follow
+ * the cursor while it stays inside the argument list.
+ */
+function createLuauSignatureHelp(): Extension {
+  return [
+    signatureTooltipField,
+    ViewPlugin.fromClass(class {
+      private request = 0;
+      
+      update(update: ViewUpdate) {
+        if (!update.docChanged && !update.selectionSet) return;
+        
+        let triggered = false;
+        update.changes.iterChanges((_fromA, _toA, _fromB, _toB, inserted) => {
+          if (/[(,]/.test(inserted.toString())) triggered = true;
+        });
+        if (!triggered && !update.state.field(signatureTooltipField)) return;
+        
+        this.query(update.view);
+      }
+      
+      async query(view: EditorView) {
+        const request = ++this.request;
+        const pos = view.state.selection.main.head;
+        const { line, col } = toLuauPosition(view.state.doc, pos);
+        const result = await getSignatureHelp(get(activeFile), line, col);
+        // A newer keystroke owns the tooltip
+        if (request !== this.request) return;
+        
+        const tooltip: Tooltip | null = result && result.signatures.length > 0
+          ? { pos, above: true, create: () => ({ dom: renderSignature(result) }) }
+          : null;
+        view.dispatch({ effects: setSignatureTooltip.of(tooltip) });
+      }
+      
+      destroy() {
+        this.request++;
+      }
+    }),
+  ];
+}
+
 // ============================================================================
 // Combined Extension
 // ============================================================================
@@ -326,12 +535,14 @@ function createLuauHover() {
  */
 export function luauLspExtensions(): Extension[] {
   return [
+    createDocumentSync(),
     createLuauLinter(),
     ...createLuauAutocomplete(),
     createLuauHover(),
+    createLuauSignatureHelp(),
   ];
 }
 
 // Export individual extensions for flexibility
-export { createLuauLinter, createLuauAutocomplete, createLuauHover };
+export { createDocumentSync, createLuauLinter, createLuauAutocomplete, createLuauHover, createLuauSignatureHelp };
 
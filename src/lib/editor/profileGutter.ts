@@ -0,0 +1,122 @@
+/**
+ * Profile Heat Gutter
+ *
+ * Shows the per-line sample counts of the last profiled run next to the
+ * line numbers of the file they belong to.
+ */
+
+import { EditorView, gutter, GutterMarker, ViewPlugin } from '@codemirror/view';
+import { RangeSet, StateEffect, StateField } from '@codemirror/state';
+import type { Extension, Range, Text } from '@codemirror/state';
+import { get } from 'svelte/store';
+import { activeFile, executionProfile } from '$lib/stores/playground';
+import type { ExecutionProfile } from '$lib/luau/types';
+
+class HeatMarker extends GutterMarker {
+  constructor(readonly count: number, readonly share: number, readonly heat: number) {
+    super();
+  }
+
+  eq(other: HeatMarker): boolean {
+    return other.count === this.count && other.heat === this.heat;
+  }
+
+  toDOM(): Node {
+    const dom = document.createElement('div');
+    dom.className = 'cm-profile-heat-marker';
+    dom.style.opacity = String(0.25 + 0.75 * this.heat);
+    dom.title = `${this.count} sample${this.count !== 1 ? 's' : ''} (${(this.share * 100).toFixed(1)}%)`;
+    return dom;
+  }
+}
+
+const setProfileHeat = StateEffect.define<RangeSet<GutterMarker>>();
+
+const profileHeatField = StateField.define<RangeSet<GutterMarker>>({
+  create: () => RangeSet.empty,
+  update(markers, tr) {
+    for (const effect of tr.effects) {
+      if (effect.is(setProfileHeat)) return effect.value;
+    }
+    // Counts stay with their lines while the file is edited
+    return tr.docChanged ? markers.map(tr.changes) : markers;
+  },
+});
+
+/** Chunk names are "main" for the run file and the require argument for modules */
+function moduleKey(name: string): string {
+  return name.replace(/^(\.\/)+/, '').replace(/\.(luau|lua)$/, '');
+}
+
+/**
+ * Line counts of `fileName` in the profile, keyed by 1-based line.
+ */
+function linesForFile(profiled: { file: string; profile: ExecutionProfile }, fileName: string): Array<[number, number]> {
+  if (fileName === profiled.file) {
+    return profiled.profile.lines['main'] ?? [];
+  }
+
+  const key = moduleKey(fileName);
+  for (const [source, lines] of Object.entries(profiled.profile.lines)) {
+    if (source !== 'main' && moduleKey(source) === key) return lines;
+  }
+  return [];
+}
+
+function buildHeat(doc: Text): RangeSet<GutterMarker> {
+  const profiled = get(executionProfile);
+  if (!profiled || profiled.profile.samples === 0) return RangeSet.empty;
+
+  const lines = linesForFile(profiled, get(activeFile));
+  const max = lines.reduce((m, [, count]) => Math.max(m, count), 0);
+
+  const markers: Range<GutterMarker>[] = [];
+  for (const [line, count] of lines) {
+    if (line < 1 || line > doc.lines) continue;
+    const marker = new HeatMarker(count, count / profiled.profile.samples, count / max);
+    markers.push(marker.range(doc.line(line).from));
+  }
+  return RangeSet.of(markers, true);
+}
+
+/**
+ * Heat gutter for the last profiled run, updated when a new profile arrives.
+ */
+export function profileHeatGutter(): Extension {
+  return [
+    profileHeatField,
+    gutter({
+      class: 'cm-profile-heat',
+      markers: (view) => view.state.field(profileHeatField),
+    }),
+    ViewPlugin.fromClass(class {
+      private unsubscribe: () => void;
+      private destroyed = false;
+
+      constructor(view: EditorView) {
+        // Subscribing replays the current profile, which also covers switching files.
+        // Views can't be updated from a plugin constructor, so the update is deferred.
+        this.unsubscribe = executionProfile.subscribe(() => {
+          queueMicrotask(() => {
+            if (!this.destroyed) view.dispatch({ effects: setProfileHeat.of(buildHeat(view.state.doc)) });
+          });
+        });
+      }
+
+      destroy() {
+        this.destroyed = true;
+        this.unsubscribe();
+      }
+    }),
+    EditorView.baseTheme({
+      '.cm-profile-heat': {
+        width: '4px',
+      },
+      '.cm-profile-heat-marker': {
+        width: '4px',
+        height: '100%',
+        background: '#e8590c',
+      },
+    }),
+  ];
+}
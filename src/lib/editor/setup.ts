@@ -16,6 +16,7 @@ import { luauTextMate, initLuauTextMate } from './textmate';
 export { initLuauTextMate };
 import { darkTheme, lightTheme } from './themes';
 import { luauLspExtensions } from './lspExtensions';
+import { profileHeatGutter } from './profileGutter';
 import { forceLinting, lintGutter } from '@codemirror/lint';
 import { themeMode } from '$lib/utils/theme';
 import { cursorLine } from '$lib/stores/playground';
@@ -60,6 +61,7 @@ function createExtensions(onChange: (content: string) => void): Extension[] {
     highlightActiveLine(),
     highlightSelectionMatches(),
     lintGutter(),
+    profileHeatGutter(),
     
     // Keymaps
     keymap.of([
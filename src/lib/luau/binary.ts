@@ -0,0 +1,351 @@
+/**
+ * Decoders for the binary result encoding (see luau_set_result_encoding in playground.cpp).
+ *
+ * Results are read straight out of wasm memory: the header and records through a DataView,
+ * strings through TextDecoder on HEAPU8 subarrays, so no intermediate JSON text is built.
+ */
+
+import type { LuauValue, SpecialFloat } from '$lib/utils/output';
+import type {
+  AutocompleteResult,
+  DiagnosticsResult,
+  ExecuteResult,
+  ExecutionCoverage,
+  ExecutionProfile,
+  HoverResult,
+  LuauCompletion,
+  LuauWasmModule,
+} from './types';
+
+const MAGIC = 0x5242504c; // "LPBR"
+const VERSION = 2;
+const HEADER_SIZE = 20;
+const NO_STRING = 0xffffffff;
+
+const enum ResultKind {
+  Execute = 1,
+  Diagnostics = 2,
+  Autocomplete = 3,
+  Hover = 4,
+  PrintBatch = 5,
+}
+
+// Printed value tags and table/userdata flags (BinaryValueWriter in playground.cpp)
+const enum ValueTag {
+  Nil = 0,
+  Boolean = 1,
+  Number = 2,
+  String = 3,
+  Table = 4,
+  Function = 5,
+  Userdata = 6,
+  Thread = 7,
+  Circular = 8,
+  Vector = 9,
+  Buffer = 10,
+}
+
+const IS_ARRAY = 1 << 0;
+const TRUNCATED = 1 << 1;
+const HAS_TOSTRING = 1 << 2;
+const NO_KEY = 0xffffffff;
+
+const COMPLETION_KINDS: LuauCompletion['kind'][] = [
+  'variable', 'property', 'keyword', 'constant', 'type', 'module', 'function',
+];
+
+const decoder = new TextDecoder();
+
+class BinaryResultReader {
+  readonly recordCount: number;
+  private view: DataView;
+  private bytes: Uint8Array;
+  private strings: Array<string | undefined>;
+  private stringOffsets: number[];
+  private pos = HEADER_SIZE;
+  private recordEnd = HEADER_SIZE;
+
+  constructor(module: LuauWasmModule, ptr: number, size: number, kind: ResultKind) {
+    this.bytes = module.HEAPU8.subarray(ptr, ptr + size);
+    this.view = new DataView(this.bytes.buffer, this.bytes.byteOffset, this.bytes.byteLength);
+
+    if (size < HEADER_SIZE || this.view.getUint32(0, true) !== MAGIC) {
+      throw new Error('Invalid binary result');
+    }
+    const version = this.view.getUint16(4, true);
+    if (version !== VERSION) {
+      throw new Error(`Unsupported binary result version ${version}`);
+    }
+    const actualKind = this.view.getUint16(6, true);
+    if (actualKind !== kind) {
+      throw new Error(`Unexpected binary result kind ${actualKind}`);
+    }
+
+    this.recordCount = this.view.getUint32(8, true);
+    const stringCount = this.view.getUint32(12, true);
+
+    // Index the string table up front; strings are decoded on first use
+    this.strings = new Array(stringCount);
+    this.stringOffsets = new Array(stringCount);
+    let offset = this.view.getUint32(16, true);
+    for (let i = 0; i < stringCount; i++) {
+      this.stringOffsets[i] = offset;
+      offset += 4 + this.view.getUint32(offset, true);
+    }
+  }
+
+  /** Whether the current record has fields left (older encoders omit appended fields) */
+  hasField(): boolean {
+    return this.pos < this.recordEnd;
+  }
+
+  /** Advance to the next record, skipping any trailing fields of the current one */
+  nextRecord(): void {
+    this.pos = this.recordEnd;
+    const length = this.view.getUint32(this.pos, true);
+    this.pos += 4;
+    this.recordEnd = this.pos + length;
+  }
+
+  u8(): number {
+    return this.view.getUint8(this.pos++);
+  }
+
+  u32(): number {
+    const v = this.view.getUint32(this.pos, true);
+    this.pos += 4;
+    return v;
+  }
+
+  i32(): number {
+    const v = this.view.getInt32(this.pos, true);
+    this.pos += 4;
+    return v;
+  }
+
+  f32(): number {
+    const v = this.view.getFloat32(this.pos, true);
+    this.pos += 4;
+    return v;
+  }
+
+  f64(): number {
+    const v = this.view.getFloat64(this.pos, true);
+    this.pos += 8;
+    return v;
+  }
+
+  /** String stored inline in the record (u32 byteLength + UTF-8), or undefined for NO_KEY */
+  inlineStr(): string | undefined {
+    const length = this.u32();
+    if (length === NO_KEY) return undefined;
+
+    const s = decoder.decode(this.bytes.subarray(this.pos, this.pos + length));
+    this.pos += length;
+    return s;
+  }
+
+  str(): string | undefined {
+    const index = this.u32();
+    if (index === NO_STRING) return undefined;
+
+    let s = this.strings[index];
+    if (s === undefined) {
+      const offset = this.stringOffsets[index];
+      const length = this.view.getUint32(offset, true);
+      s = decoder.decode(this.bytes.subarray(offset + 4, offset + 4 + length));
+      this.strings[index] = s;
+    }
+    return s;
+  }
+}
+
+/**
+ * Numbers as the JSON encoding writes them (%.14g, vector components %.7g), so both
+ * encodings print the same text.
+ */
+function printedNumber(value: number, precision: number): number | SpecialFloat {
+  if (Number.isNaN(value)) return 'nan';
+  if (!Number.isFinite(value)) return value > 0 ? 'inf' : '-inf';
+  if (Number.isInteger(value) && Math.abs(value) < 2 ** 63) return value;
+  return Number(value.toPrecision(precision));
+}
+
+function readValue(r: BinaryResultReader): LuauValue {
+  switch (r.u8()) {
+    case ValueTag.Boolean:
+      return { type: 'boolean', value: r.u8() !== 0 };
+    case ValueTag.Number:
+      return { type: 'number', value: printedNumber(r.f64(), 14) };
+    case ValueTag.String:
+      return { type: 'string', value: r.inlineStr() ?? '' };
+    case ValueTag.Table:
+      return readTable(r);
+    case ValueTag.Function:
+      return { type: 'function' };
+    case ValueTag.Userdata: {
+      const flags = r.u8();
+      const tostring = flags & HAS_TOSTRING ? r.inlineStr() : undefined;
+      return tostring !== undefined ? { type: 'userdata', tostring } : { type: 'userdata' };
+    }
+    case ValueTag.Thread:
+      return { type: 'thread' };
+    case ValueTag.Circular:
+      return { type: 'circular' };
+    case ValueTag.Vector: {
+      const components: (number | SpecialFloat)[] = [];
+      for (let i = r.u8(); i > 0; i--) components.push(printedNumber(r.f32(), 7));
+      return { type: 'vector', value: components };
+    }
+    case ValueTag.Buffer:
+      return { type: 'buffer', size: r.u32() };
+    default:
+      return { type: 'nil' };
+  }
+}
+
+type LuauTable = Extract<LuauValue, { type: 'table' }>;
+
+function readTable(r: BinaryResultReader): LuauTable {
+  const flags = r.u8();
+  const count = r.u32();
+  const isArray = (flags & IS_ARRAY) !== 0;
+
+  let value: Record<string, LuauValue> | LuauValue[];
+  if (isArray) {
+    const elements: LuauValue[] = [];
+    for (let i = 0; i < count; i++) {
+      r.u32(); // NO_KEY
+      elements.push(readValue(r));
+    }
+    value = elements;
+  } else {
+    // Entries before the first non-sequential key have no key: they are 1, 2, ...
+    const entries: Record<string, LuauValue> = {};
+    for (let i = 0; i < count; i++) {
+      const key = r.inlineStr() ?? String(i + 1);
+      // Own property even for "__proto__", as JSON.parse would create it
+      Object.defineProperty(entries, key, { value: readValue(r), enumerable: true, writable: true, configurable: true });
+    }
+    value = entries;
+  }
+
+  const table: LuauTable = { type: 'table', value, isArray };
+  if (flags & TRUNCATED) table.truncated = { handle: r.u32(), offset: r.u32() };
+  if (flags & HAS_TOSTRING) table.tostring = r.inlineStr();
+  return table;
+}
+
+/** Arguments of one print call: the current record's values, back to back */
+function readPrintRecord(r: BinaryResultReader): LuauValue[] {
+  const values: LuauValue[] = [];
+  while (r.hasField()) values.push(readValue(r));
+  return values;
+}
+
+function reader(module: LuauWasmModule, ptr: number, kind: ResultKind): BinaryResultReader {
+  const size = module.ccall('luau_result_size', 'number', [], []);
+  return new BinaryResultReader(module, ptr, size, kind);
+}
+
+export function decodeExecuteResult(module: LuauWasmModule, ptr: number): ExecuteResult {
+  const r = reader(module, ptr, ResultKind.Execute);
+
+  r.nextRecord();
+  const result: ExecuteResult = {
+    success: r.u8() !== 0,
+    output: '',
+  };
+  const interrupted = r.u8() !== 0;
+  const dropped = r.u32();
+  result.output = r.str() ?? '';
+  const error = r.str();
+  const streamed = r.u8() !== 0;
+  const flushes = r.u32();
+  const records = r.u32();
+  const bytes = r.u32();
+  const firstFlushMs = r.i32();
+  const profile = r.hasField() ? r.str() : undefined;
+  const coverage = r.hasField() ? r.str() : undefined;
+  if (r.hasField()) {
+    const limitBytes = r.u32();
+    const peakBytes = r.u32();
+    const allocations = r.u32();
+    const gcCycles = r.u32();
+    const outOfMemory = r.u8() !== 0;
+    result.memory = { limitBytes, peakBytes, allocations, gcCycles };
+    if (outOfMemory) result.memory.outOfMemory = true;
+  }
+
+  if (error !== undefined) result.error = error;
+  if (interrupted) result.interrupted = true;
+  if (dropped > 0) result.droppedPrints = dropped;
+  if (streamed) result.stream = { flushes, records, bytes, firstFlushMs };
+  if (profile !== undefined) result.profile = JSON.parse(profile) as ExecutionProfile;
+  if (coverage !== undefined) result.coverage = JSON.parse(coverage) as ExecutionCoverage;
+
+  const prints: LuauValue[][] = [];
+  for (let i = 1; i < r.recordCount; i++) {
+    r.nextRecord();
+    prints.push(readPrintRecord(r));
+  }
+  result.prints = prints;
+
+  return result;
+}
+
+/** Print records streamed during a run (Module.onPrintBatchBinary); `size` is the batch length */
+export function decodePrintBatch(module: LuauWasmModule, ptr: number, size: number): LuauValue[][] {
+  const r = new BinaryResultReader(module, ptr, size, ResultKind.PrintBatch);
+  const prints: LuauValue[][] = [];
+  for (let i = 0; i < r.recordCount; i++) {
+    r.nextRecord();
+    prints.push(readPrintRecord(r));
+  }
+  return prints;
+}
+
+export function decodeDiagnosticsResult(module: LuauWasmModule, ptr: number): DiagnosticsResult {
+  const r = reader(module, ptr, ResultKind.Diagnostics);
+  const diagnostics: DiagnosticsResult['diagnostics'] = [];
+
+  for (let i = 0; i < r.recordCount; i++) {
+    r.nextRecord();
+    r.u8(); // severity: only errors are reported today
+    diagnostics.push({
+      severity: 'error',
+      message: r.str() ?? '',
+      startLine: r.i32(),
+      startCol: r.i32(),
+      endLine: r.i32(),
+      endCol: r.i32(),
+    });
+  }
+
+  return { diagnostics };
+}
+
+export function decodeAutocompleteResult(module: LuauWasmModule, ptr: number): AutocompleteResult {
+  const r = reader(module, ptr, ResultKind.Autocomplete);
+  const items: LuauCompletion[] = [];
+
+  for (let i = 0; i < r.recordCount; i++) {
+    r.nextRecord();
+    const label = r.str() ?? '';
+    const kind = COMPLETION_KINDS[r.u8()] ?? 'variable';
+    const detail = r.str();
+    const deprecated = r.u8() !== 0;
+
+    const item: LuauCompletion = { label, kind, deprecated };
+    if (detail !== undefined) item.detail = detail;
+    items.push(item);
+  }
+
+  return { items };
+}
+
+export function decodeHoverResult(module: LuauWasmModule, ptr: number): HoverResult {
+  const r = reader(module, ptr, ResultKind.Hover);
+  r.nextRecord();
+  return { content: r.str() ?? null };
+}
@@ -2,7 +2,8 @@
  * Luau WASM Web Worker
  * 
  * Runs Luau WASM execution in a separate thread to prevent UI blocking.
- * Allows for termination of infinite loops by killing the worker.
+ * Infinite loops are stopped through a shared interrupt flag polled by the VM;
+ * killing the worker remains the fallback when shared memory is unavailable.
  */
 
 import type { 
@@ -10,9 +11,29 @@ import type {
   ExecuteResult, 
   DiagnosticsResult, 
   AutocompleteResult, 
+  CompletionDetails,
   HoverResult,
+  SignatureResult,
+  InspectResult,
+  DocumentEdit,
+  AnalysisStats,
+  MemoryStats,
+  DumpResult,
+  DumpFormatName,
+  DumpFunctionsResult,
+  TraceResult,
+  BenchmarkResult,
   CreateLuauModule 
 } from './types';
+import { DUMP_FORMATS, DUMP_STATS_BIT } from './types';
+import type { LuauValue } from '$lib/utils/output';
+import {
+  decodeExecuteResult,
+  decodePrintBatch,
+  decodeDiagnosticsResult,
+  decodeAutocompleteResult,
+  decodeHoverResult,
+} from './binary';
 import createLuauModuleFactory from './luau-module.js';
 
 // The WASM module singleton within this worker
@@ -20,35 +41,89 @@ let wasmModule: LuauWasmModule | null = null;
 let modulePromise: Promise<LuauWasmModule> | null = null;
 // Pre-compiled WebAssembly.Module from main thread
 let compiledWasmModule: WebAssembly.Module | null = null;
+// Stop flag shared with the main thread (only when cross-origin isolated)
+let interruptFlag: Int32Array | undefined;
+// JS module of a build that is served rather than bundled (SIMD and execution-only builds)
+let moduleUrl: string | undefined;
 
 // Message types for worker communication
 export type WorkerRequest = 
-  | { type: 'init'; wasmModule: WebAssembly.Module }
-  | { type: 'execute'; code: string }
-  | { type: 'getDiagnostics'; code: string }
-  | { type: 'autocomplete'; code: string; line: number; col: number }
-  | { type: 'hover'; code: string; line: number; col: number }
+  | { type: 'init'; wasmModule: WebAssembly.Module; interruptFlag?: Int32Array; moduleUrl?: string }
+  | { type: 'execute'; code: string; timeLimit: number }
+  | { type: 'reset' }
+  | { type: 'benchmark'; code: string; iterations: number; warmup: number; optimizationLevel: number; functionName: string }
+  | { type: 'setPrintStreaming'; enabled: boolean; flushIntervalMs: number; flushBytes: number; maxOutputBytes: number }
+  | { type: 'setPrintText'; enabled: boolean }
+  | { type: 'setProfiling'; enabled: boolean; intervalUs: number }
+  | { type: 'setCoverage'; level: number }
+  | { type: 'setCompileOptions'; optimizationLevel: number; debugLevel: number; typeInfoLevel: number; coverageLevel: number; vectorLib: string; vectorCtor: string; vectorType: string }
+  | { type: 'setMemoryLimit'; limitBytes: number }
+  | { type: 'setTracing'; enabled: boolean; pid: number }
+  | { type: 'takeTrace' }
+  | { type: 'setSerializeLimits'; maxDepth: number; maxWidth: number; maxBytes: number }
+  | { type: 'inspectValue'; handle: number; path: string[]; offset: number }
+  | { type: 'setDocuments'; sources: Record<string, string> }
+  | { type: 'applyEdits'; name: string; edits: DocumentEdit[] }
+  | { type: 'closeDocuments'; names: string[] }
+  | { type: 'getDiagnostics'; name: string; version: number }
+  | { type: 'autocomplete'; name: string; version: number; line: number; col: number; prefix: string; limit: number }
+  | { type: 'resolveCompletion'; label: string }
+  | { type: 'hover'; name: string; version: number; line: number; col: number }
+  | { type: 'signatureHelp'; name: string; version: number; line: number; col: number }
   | { type: 'getModules' }
+  | { type: 'getAnalysisStats' }
+  | { type: 'setCheckTimeLimit'; timeLimitMs: number }
+  | { type: 'setMemoryBudget'; budgetBytes: number }
+  | { type: 'getMemoryStats' }
+  | { type: 'initAnalysis' }
   | { type: 'setMode'; mode: number }
   | { type: 'setSolver'; isNew: boolean }
-  | { type: 'getBytecode'; code: string; optimizationLevel: number; debugLevel: number; outputFormat: number; showRemarks: boolean }
-  | { type: 'registerModules'; modules: Record<string, string> }
-  | { type: 'registerSources'; sources: Record<string, string> };
+  | { type: 'dumpAll'; code: string; optimizationLevel: number; debugLevel: number; formats: DumpFormatName[]; showRemarks: boolean; stats?: boolean }
+  | { type: 'dumpFunctions'; code: string; optimizationLevel: number; debugLevel: number; showRemarks: boolean }
+  | { type: 'dumpFunction'; code: string; optimizationLevel: number; debugLevel: number; outputFormat: number; functionId: number; showRemarks: boolean }
+  | { type: 'registerModules'; modules: Record<string, string> };
 
 export type WorkerResponse = 
-  | { type: 'ready' }
+  | { type: 'ready'; cancelFlag?: { memory: SharedArrayBuffer; offset: number } }
+  | { type: 'setCheckTimeLimit'; success: boolean }
+  | { type: 'setMemoryBudget'; success: boolean }
+  | { type: 'getMemoryStats'; result: MemoryStats }
+  | { type: 'initAnalysis'; elapsed: number }
   | { type: 'execute'; result: ExecuteResult; elapsed: number }
+  | { type: 'reset'; success: boolean }
+  | { type: 'benchmark'; result: BenchmarkResult }
+  | { type: 'setPrintStreaming'; success: boolean }
+  | { type: 'setPrintText'; success: boolean }
+  | { type: 'setProfiling'; success: boolean }
+  | { type: 'setCoverage'; success: boolean }
+  | { type: 'setCompileOptions'; success: boolean }
+  | { type: 'setMemoryLimit'; success: boolean }
+  | { type: 'setTracing'; success: boolean }
+  | { type: 'takeTrace'; result: TraceResult; timeOrigin: number }
+  | { type: 'setSerializeLimits'; success: boolean }
+  | { type: 'inspectValue'; result: InspectResult }
+  | { type: 'setDocuments'; versions: Record<string, number> }
+  | { type: 'applyEdits'; version: number }
+  | { type: 'closeDocuments'; success: boolean }
   | { type: 'getDiagnostics'; result: DiagnosticsResult; elapsed: number }
   | { type: 'autocomplete'; result: AutocompleteResult }
+  | { type: 'resolveCompletion'; result: CompletionDetails | null }
   | { type: 'hover'; result: HoverResult }
+  | { type: 'signatureHelp'; result: SignatureResult }
   | { type: 'getModules'; result: { modules: string[] } }
+  | { type: 'getAnalysisStats'; result: AnalysisStats }
   | { type: 'setMode'; success: boolean }
   | { type: 'setSolver'; success: boolean }
-  | { type: 'getBytecode'; result: { success: boolean; bytecode: string; error?: string } }
+  | { type: 'dumpAll'; result: DumpResult }
+  | { type: 'dumpFunctions'; result: DumpFunctionsResult }
+  | { type: 'dumpFunction'; result: { success: boolean; bytecode: string; error?: string } }
   | { type: 'registerModules'; success: boolean }
-  | { type: 'registerSources'; success: boolean }
   | { type: 'error'; error: string };
 
+// Unsolicited messages posted while a request is still running
+export type WorkerEvent = 
+  | { type: 'printBatch'; prints: LuauValue[][] };
+
 async function loadModule(): Promise<LuauWasmModule> {
   if (wasmModule) return wasmModule;
   if (modulePromise) return modulePromise;
@@ -60,7 +135,17 @@ async function loadModule(): Promise<LuauWasmModule> {
   modulePromise = (async () => {
     // Use instantiateWasm to leverage the pre-compiled WebAssembly.Module
     // This avoids recompiling the WASM in each worker
-    const module = await (createLuauModuleFactory as CreateLuauModule)({
+    const factory = moduleUrl
+      ? ((await import(/* @vite-ignore */ moduleUrl)) as { default: CreateLuauModule }).default
+      : (createLuauModuleFactory as CreateLuauModule);
+    const module = await factory({
+      playgroundInterrupt: interruptFlag,
+      onPrintBatch: (json) => {
+        self.postMessage({ type: 'printBatch', prints: JSON.parse(json) } satisfies WorkerEvent);
+      },
+      onPrintBatchBinary: (ptr, size) => {
+        self.postMessage({ type: 'printBatch', prints: decodePrintBatch(module, ptr, size) } satisfies WorkerEvent);
+      },
       instantiateWasm: (imports, successCallback) => {
         WebAssembly.instantiate(compiledWasmModule!, imports)
           .then((instance) => {
@@ -71,6 +156,13 @@ async function loadModule(): Promise<LuauWasmModule> {
       },
     });
 
+    // Results are decoded directly from wasm memory (see binary.ts); a module built before
+    // the binary encoding would return JSON strings the decoders can't read
+    if (!('_luau_set_result_encoding' in module)) {
+      throw new Error('The Luau wasm module is out of date; rebuild it with wasm/build.sh');
+    }
+    module.ccall('luau_set_result_encoding', null, ['number'], [1]);
+
     wasmModule = module;
     return module;
   })();
@@ -79,29 +171,11 @@ async function loadModule(): Promise<LuauWasmModule> {
 }
 
 /**
- * Register a file with both its original name and without extension.
- * This allows require("foo") to work for "foo.luau".
+ * Register a module for require. The module registry also resolves it without
+ * its extension, so require("foo") works for "foo.luau".
  */
-function registerFile(
-  module: LuauWasmModule,
-  name: string,
-  content: string,
-  fn: 'luau_add_module' | 'luau_set_source'
-): void {
-  // Use type narrowing to satisfy TypeScript's overload resolution
-  const register = (filename: string) => {
-    if (fn === 'luau_add_module') {
-      module.ccall('luau_add_module', null, ['string', 'string'], [filename, content]);
-    } else {
-      module.ccall('luau_set_source', null, ['string', 'string'], [filename, content]);
-    }
-  };
-
-  register(name);
-  const nameWithoutExt = name.replace(/\.(luau|lua)$/, '');
-  if (nameWithoutExt !== name) {
-    register(nameWithoutExt);
-  }
+function registerFile(module: LuauWasmModule, name: string, content: string): void {
+  module.ccall('luau_add_module', null, ['string', 'string'], [name, content]);
 }
 
 // Helper to send response with requestId
@@ -118,55 +192,248 @@ self.onmessage = async (e: MessageEvent<WorkerRequest & { requestId: string }>)
       case 'init': {
         // Store the pre-compiled WebAssembly.Module from main thread
         compiledWasmModule = request.wasmModule;
-        await loadModule();
-        respond(requestId, { type: 'ready' });
+        interruptFlag = request.interruptFlag;
+        moduleUrl = request.moduleUrl;
+        const module = await loadModule();
+        // With shared wasm memory the main thread can cancel a running check directly
+        const memory = module.HEAPU8.buffer;
+        if (typeof SharedArrayBuffer !== 'undefined' && memory instanceof SharedArrayBuffer) {
+          const offset = module.ccall('luau_analysis_cancel_flag', 'number', [], []);
+          respond(requestId, { type: 'ready', cancelFlag: { memory, offset } });
+        } else {
+          respond(requestId, { type: 'ready' });
+        }
         break;
       }
       
       case 'execute': {
         const module = await loadModule();
         const startTime = performance.now();
-        const resultJson = module.ccall('luau_execute', 'string', ['string'], [request.code]);
+        const resultPtr = module.ccall('luau_execute', 'number', ['string', 'number', 'number'], [request.code, request.timeLimit, 0]);
+        const result = resultPtr ? decodeExecuteResult(module, resultPtr) : undefined;
         const elapsed = performance.now() - startTime;
-        if (!resultJson) {
+        if (!result) {
           respond(requestId, { 
             type: 'execute', 
             result: { success: false, output: '', error: 'No result returned from execution' },
             elapsed
           });
         } else {
-          const parsed = JSON.parse(resultJson) as ExecuteResult;
-          respond(requestId, { type: 'execute', result: parsed, elapsed });
+          respond(requestId, { type: 'execute', result, elapsed });
+        }
+        break;
+      }
+      
+      case 'benchmark': {
+        const module = await loadModule();
+        const resultJson = module.ccall(
+          'luau_benchmark',
+          'string',
+          ['string', 'number', 'number', 'number', 'string'],
+          [request.code, request.iterations, request.warmup, request.optimizationLevel, request.functionName]
+        );
+        respond(requestId, { type: 'benchmark', result: JSON.parse(resultJson) as BenchmarkResult });
+        break;
+      }
+      
+      case 'reset': {
+        const module = await loadModule();
+        module.ccall('luau_reset', null, [], []);
+        respond(requestId, { type: 'reset', success: true });
+        break;
+      }
+      
+      case 'setPrintStreaming': {
+        const module = await loadModule();
+        module.ccall(
+          'luau_set_print_streaming',
+          null,
+          ['boolean', 'number', 'number', 'number'],
+          [request.enabled, request.flushIntervalMs, request.flushBytes, request.maxOutputBytes]
+        );
+        respond(requestId, { type: 'setPrintStreaming', success: true });
+        break;
+      }
+      
+      case 'setPrintText': {
+        const module = await loadModule();
+        module.ccall('luau_set_print_text', null, ['boolean'], [request.enabled]);
+        respond(requestId, { type: 'setPrintText', success: true });
+        break;
+      }
+      
+      case 'setProfiling': {
+        const module = await loadModule();
+        module.ccall('luau_set_profiling', null, ['boolean', 'number'], [request.enabled, request.intervalUs]);
+        respond(requestId, { type: 'setProfiling', success: true });
+        break;
+      }
+      
+      case 'setCoverage': {
+        const module = await loadModule();
+        module.ccall('luau_set_coverage', null, ['number'], [request.level]);
+        respond(requestId, { type: 'setCoverage', success: true });
+        break;
+      }
+      
+      case 'setCompileOptions': {
+        const module = await loadModule();
+        module.ccall(
+          'luau_set_compile_options',
+          null,
+          ['number', 'number', 'number', 'number', 'string', 'string', 'string'],
+          [request.optimizationLevel, request.debugLevel, request.typeInfoLevel, request.coverageLevel,
+           request.vectorLib, request.vectorCtor, request.vectorType]
+        );
+        respond(requestId, { type: 'setCompileOptions', success: true });
+        break;
+      }
+      
+      case 'setMemoryLimit': {
+        const module = await loadModule();
+        module.ccall('luau_set_memory_limit', null, ['number'], [request.limitBytes]);
+        respond(requestId, { type: 'setMemoryLimit', success: true });
+        break;
+      }
+      
+      case 'setTracing': {
+        const module = await loadModule();
+        module.ccall('luau_set_tracing', null, ['boolean', 'number'], [request.enabled, request.pid]);
+        respond(requestId, { type: 'setTracing', success: true });
+        break;
+      }
+      
+      case 'takeTrace': {
+        const module = await loadModule();
+        const result = JSON.parse(module.ccall('luau_take_trace', 'string', [], [])) as TraceResult;
+        // Timestamps are relative to this worker's clock
+        respond(requestId, { type: 'takeTrace', result, timeOrigin: performance.timeOrigin });
+        break;
+      }
+      
+      case 'setSerializeLimits': {
+        const module = await loadModule();
+        module.ccall(
+          'luau_set_serialize_limits',
+          null,
+          ['number', 'number', 'number'],
+          [request.maxDepth, request.maxWidth, request.maxBytes]
+        );
+        respond(requestId, { type: 'setSerializeLimits', success: true });
+        break;
+      }
+      
+      case 'inspectValue': {
+        const module = await loadModule();
+        // Path segments are joined with the unit separator expected by the C++ side
+        const resultJson = module.ccall(
+          'luau_inspect_value',
+          'string',
+          ['number', 'string', 'number'],
+          [request.handle, request.path.join('\x1f'), request.offset]
+        );
+        const result = JSON.parse(resultJson) as InspectResult;
+        respond(requestId, { type: 'inspectValue', result });
+        break;
+      }
+      
+      case 'setDocuments': {
+        const module = await loadModule();
+        const versions: Record<string, number> = {};
+        for (const [name, content] of Object.entries(request.sources)) {
+          // Unchanged text keeps its version and its check results
+          module.ccall('luau_set_source', null, ['string', 'string'], [name, content]);
+          versions[name] = module.ccall('luau_document_version', 'number', ['string'], [name]);
+        }
+        respond(requestId, { type: 'setDocuments', versions });
+        break;
+      }
+      
+      case 'applyEdits': {
+        const module = await loadModule();
+        let version = -1;
+        for (const edit of request.edits) {
+          version = module.ccall(
+            'luau_apply_edit',
+            'number',
+            ['string', 'number', 'number', 'number', 'number', 'string'],
+            [request.name, edit.startLine, edit.startCol, edit.endLine, edit.endCol, edit.text]
+          );
+          if (version < 0) break;
         }
+        respond(requestId, { type: 'applyEdits', version });
+        break;
+      }
+      
+      case 'closeDocuments': {
+        const module = await loadModule();
+        for (const name of request.names) {
+          module.ccall('luau_close_document', null, ['string'], [name]);
+        }
+        respond(requestId, { type: 'closeDocuments', success: true });
         break;
       }
       
       case 'getDiagnostics': {
         const module = await loadModule();
         const startTime = performance.now();
-        const resultJson = module.ccall('luau_get_diagnostics', 'string', ['string'], [request.code]);
+        const resultPtr = module.ccall('luau_get_diagnostics', 'number', ['string', 'number'], [request.name, request.version]);
+        const result = decodeDiagnosticsResult(module, resultPtr);
+        if (module.ccall('luau_analysis_cancelled', 'boolean', [], [])) result.cancelled = true;
         const elapsed = performance.now() - startTime;
-        const result = JSON.parse(resultJson) as DiagnosticsResult;
         respond(requestId, { type: 'getDiagnostics', result, elapsed });
         break;
       }
       
       case 'autocomplete': {
         const module = await loadModule();
-        const resultJson = module.ccall('luau_autocomplete', 'string', ['string', 'number', 'number'], [request.code, request.line, request.col]);
-        const result = JSON.parse(resultJson) as AutocompleteResult;
+        const resultPtr = module.ccall(
+          'luau_autocomplete',
+          'number',
+          ['string', 'number', 'number', 'number', 'string', 'number'],
+          [request.name, request.version, request.line, request.col, request.prefix, request.limit]
+        );
+        const result = decodeAutocompleteResult(module, resultPtr);
         respond(requestId, { type: 'autocomplete', result });
         break;
       }
       
+      case 'resolveCompletion': {
+        const module = await loadModule();
+        // Always JSON, whatever the result encoding
+        const resultJson = module.ccall('luau_autocomplete_resolve', 'string', ['string'], [request.label]);
+        const { item } = JSON.parse(resultJson) as { item: CompletionDetails | null };
+        respond(requestId, { type: 'resolveCompletion', result: item });
+        break;
+      }
+      
       case 'hover': {
         const module = await loadModule();
-        const resultJson = module.ccall('luau_hover', 'string', ['string', 'number', 'number'], [request.code, request.line, request.col]);
-        const result = JSON.parse(resultJson) as HoverResult;
+        const resultPtr = module.ccall(
+          'luau_hover',
+          'number',
+          ['string', 'number', 'number', 'number'],
+          [request.name, request.version, request.line, request.col]
+        );
+        const result = decodeHoverResult(module, resultPtr);
         respond(requestId, { type: 'hover', result });
         break;
       }
       
+      case 'signatureHelp': {
+        const module = await loadModule();
+        // Always JSON, whatever the result encoding
+        const resultJson = module.ccall(
+          'luau_signature_help',
+          'string',
+          ['string', 'number', 'number', 'number'],
+          [request.name, request.version, request.line, request.col]
+        );
+        const result = JSON.parse(resultJson) as SignatureResult;
+        respond(requestId, { type: 'signatureHelp', result });
+        break;
+      }
+      
       case 'getModules': {
         const module = await loadModule();
         const resultJson = module.ccall('luau_get_modules', 'string', [], []);
@@ -175,6 +442,43 @@ self.onmessage = async (e: MessageEvent<WorkerRequest & { requestId: string }>)
         break;
       }
       
+      case 'getAnalysisStats': {
+        const module = await loadModule();
+        const resultJson = module.ccall('luau_get_analysis_stats', 'string', [], []);
+        const result = JSON.parse(resultJson) as AnalysisStats;
+        respond(requestId, { type: 'getAnalysisStats', result });
+        break;
+      }
+      
+      case 'setCheckTimeLimit': {
+        const module = await loadModule();
+        module.ccall('luau_set_check_time_limit', null, ['number'], [request.timeLimitMs]);
+        respond(requestId, { type: 'setCheckTimeLimit', success: true });
+        break;
+      }
+      
+      case 'setMemoryBudget': {
+        const module = await loadModule();
+        module.ccall('luau_set_analysis_memory_budget', null, ['number'], [request.budgetBytes]);
+        respond(requestId, { type: 'setMemoryBudget', success: true });
+        break;
+      }
+      
+      case 'getMemoryStats': {
+        const module = await loadModule();
+        const resultJson = module.ccall('luau_memory_stats', 'string', [], []);
+        const result = JSON.parse(resultJson) as MemoryStats;
+        respond(requestId, { type: 'getMemoryStats', result });
+        break;
+      }
+      
+      case 'initAnalysis': {
+        const module = await loadModule();
+        const elapsed = module.ccall('luau_init_analysis', 'number', [], []);
+        respond(requestId, { type: 'initAnalysis', elapsed });
+        break;
+      }
+      
       case 'setMode': {
         const module = await loadModule();
         module.ccall('luau_set_mode', null, ['number'], [request.mode]);
@@ -189,16 +493,44 @@ self.onmessage = async (e: MessageEvent<WorkerRequest & { requestId: string }>)
         break;
       }
       
-      case 'getBytecode': {
+      case 'dumpAll': {
         const module = await loadModule();
+        const formatMask = request.formats.reduce((mask, format) => mask | (1 << DUMP_FORMATS.indexOf(format)), 0)
+          | (request.stats ? DUMP_STATS_BIT : 0);
         const resultJson = module.ccall(
-          'luau_dump_bytecode',
+          'luau_dump_all',
           'string',
           ['string', 'number', 'number', 'number', 'number'],
-          [request.code, request.optimizationLevel, request.debugLevel, request.outputFormat, request.showRemarks ? 1 : 0]
+          [request.code, request.optimizationLevel, request.debugLevel, formatMask, request.showRemarks ? 1 : 0]
+        );
+        const result = JSON.parse(resultJson) as DumpResult;
+        respond(requestId, { type: 'dumpAll', result });
+        break;
+      }
+      
+      case 'dumpFunctions': {
+        const module = await loadModule();
+        const resultJson = module.ccall(
+          'luau_dump_functions',
+          'string',
+          ['string', 'number', 'number', 'number'],
+          [request.code, request.optimizationLevel, request.debugLevel, request.showRemarks ? 1 : 0]
+        );
+        const result = JSON.parse(resultJson) as DumpFunctionsResult;
+        respond(requestId, { type: 'dumpFunctions', result });
+        break;
+      }
+      
+      case 'dumpFunction': {
+        const module = await loadModule();
+        const resultJson = module.ccall(
+          'luau_dump_function',
+          'string',
+          ['string', 'number', 'number', 'number', 'number', 'number'],
+          [request.code, request.optimizationLevel, request.debugLevel, request.outputFormat, request.functionId, request.showRemarks ? 1 : 0]
         );
         const result = JSON.parse(resultJson);
-        respond(requestId, { type: 'getBytecode', result });
+        respond(requestId, { type: 'dumpFunction', result });
         break;
       }
       
@@ -208,21 +540,12 @@ self.onmessage = async (e: MessageEvent<WorkerRequest & { requestId: string }>)
         module.ccall('luau_clear_modules', null, [], []);
         // Register each module
         for (const [name, content] of Object.entries(request.modules)) {
-          registerFile(module, name, content, 'luau_add_module');
+          registerFile(module, name, content);
         }
         respond(requestId, { type: 'registerModules', success: true });
         break;
       }
       
-      case 'registerSources': {
-        const module = await loadModule();
-        for (const [name, content] of Object.entries(request.sources)) {
-          registerFile(module, name, content, 'luau_set_source');
-        }
-        respond(requestId, { type: 'registerSources', success: true });
-        break;
-      }
-      
       default: {
         const exhaustiveCheck: never = request;
         respond(requestId, { type: 'error', error: `Unknown request type: ${(exhaustiveCheck as WorkerRequest).type}` });
@@ -20,21 +20,209 @@ export interface LuauCompletion {
   deprecated: boolean;
 }
 
+export interface PrintStreamStats {
+  flushes: number;
+  records: number;
+  bytes: number;
+  /** Time from run start to the first delivered batch, -1 if nothing was flushed */
+  firstFlushMs: number;
+}
+
 export interface ExecuteResult {
   success: boolean;
   output: string;
   prints?: LuauValue[][];
   error?: string;
+  /** Set when the run was aborted by the VM interrupt (stop request or budget) */
+  interrupted?: boolean;
+  /** Print calls dropped after the output cap was reached */
+  droppedPrints?: number;
+  /** Present when prints were streamed during the run instead of returned here */
+  stream?: PrintStreamStats;
+  /** Present when the run was profiled (luau_set_profiling) */
+  profile?: ExecutionProfile;
+  /** Present when the run was compiled with coverage (luau_set_coverage) */
+  coverage?: ExecutionCoverage;
+  memory?: ExecutionMemoryStats;
+}
+
+export interface ExecutionMemoryStats {
+  /** Per-run cap (luau_set_memory_limit), 0 = unlimited */
+  limitBytes: number;
+  /** Peak bytes allocated by the run on top of the template state */
+  peakBytes: number;
+  allocations: number;
+  gcCycles: number;
+  /** Set when the run hit the cap */
+  outOfMemory?: boolean;
+}
+
+export interface FileCoverage {
+  /** Executable lines as flat [line, hits, line, hits, ...] pairs, 1-based and ascending */
+  lines: number[];
+  /** Executable lines hit at least once */
+  covered: number;
+  /** Executable lines */
+  total: number;
+}
+
+export interface ExecutionCoverage {
+  level: 1 | 2;
+  /** Keyed by "main" for the run file and the registered module name for required modules */
+  files: Record<string, FileCoverage>;
+}
+
+export interface ProfileStack {
+  /** Collapsed frames, root first, separated by ';' */
+  stack: string;
+  count: number;
+}
+
+export interface ProfileFunction {
+  name: string;
+  source: string;
+  /** Line the function is defined on */
+  line: number;
+  /** Samples with the function on top of the stack */
+  self: number;
+  /** Samples with the function anywhere on the stack */
+  total: number;
+}
+
+export interface ExecutionProfile {
+  intervalMs: number;
+  durationMs: number;
+  samples: number;
+  /** Samples whose stack was deeper than the capture limit */
+  truncated: number;
+  /** Hottest first */
+  stacks: ProfileStack[];
+  /** Hottest first */
+  functions: ProfileFunction[];
+  /** Self samples per chunk name ("main" or the required module name) as [line, count] pairs */
+  lines: Record<string, Array<[number, number]>>;
+}
+
+/** Chrome trace-event format; "X" spans from the workers, "M" metadata added by the host */
+export interface TraceEvent {
+  name: string;
+  cat?: string;
+  ph: 'X' | 'M';
+  /** Microseconds */
+  ts: number;
+  dur?: number;
+  pid: number;
+  tid: number;
+  args: Record<string, unknown>;
+}
+
+export interface TraceResult {
+  traceEvents: TraceEvent[];
+  /** Spans not recorded because the buffer was full */
+  droppedEvents: number;
+}
+
+export interface BenchmarkLevelResult {
+  optimizationLevel: number;
+  success: boolean;
+  /** Parse and compile time of the source, never served from the bytecode cache */
+  compileMs: number;
+  error?: string;
+  minMs?: number;
+  maxMs?: number;
+  meanMs?: number;
+  medianMs?: number;
+  p95Ms?: number;
+  stddevMs?: number;
+  allocationsPerIteration?: number;
+  allocatedBytesPerIteration?: number;
+  gcCyclesPerIteration?: number;
+}
+
+export interface BenchmarkResult {
+  success: boolean;
+  iterations: number;
+  warmup: number;
+  function?: string;
+  interrupted?: boolean;
+  error?: string;
+  levels: BenchmarkLevelResult[];
+  /** Median of the first level divided by each level's median (only when comparing levels) */
+  comparison?: Array<{ optimizationLevel: number; speedup: number }>;
+}
+
+export interface InspectResult {
+  success: boolean;
+  value?: LuauValue;
+  error?: string;
+}
+
+/** Replacement of a range in a document (0-based lines, UTF-8 byte columns) */
+export interface DocumentEdit {
+  startLine: number;
+  startCol: number;
+  endLine: number;
+  endCol: number;
+  text: string;
+}
+
+/** Shared check cache counters and startup timings of the analysis worker */
+export interface AnalysisStats {
+  checkHits: number;
+  checkMisses: number;
+  checkCancelled: number;
+  /** Cold start phases in ms; -1 for phases that have not run (autocomplete globals are lazy) */
+  startup: {
+    frontendMs: number;
+    globalsMs: number;
+    autocompleteGlobalsMs: number;
+  };
+}
+
+export interface ModuleMemoryStats {
+  name: string;
+  /** false once only the exported interface is kept (memory budget) */
+  fullTypeGraph: boolean;
+  internalTypes: number;
+  internalTypePacks: number;
+  interfaceTypes: number;
+  interfaceTypePacks: number;
+  /** Approximate type arena bytes, autocomplete pass included */
+  bytes: number;
+}
+
+export interface MemoryStats {
+  heapBytes: number;
+  heapUsedBytes: number;
+  /** 0 when every module keeps its full type graph */
+  budgetBytes: number;
+  arenaBytes: number;
+  evictedModules: number;
+  activeDocument: string;
+  modules: ModuleMemoryStats[];
 }
 
 export interface DiagnosticsResult {
   diagnostics: LuauDiagnostic[];
+  /** The check was aborted by a newer request; diagnostics is empty */
+  cancelled?: boolean;
 }
 
 export interface AutocompleteResult {
   items: LuauCompletion[];
 }
 
+/** Full details of a completion item (luau_autocomplete_resolve) */
+export interface CompletionDetails {
+  label: string;
+  kind: LuauCompletion['kind'];
+  /** Complete type, where the list's detail may be truncated */
+  detail?: string;
+  /** Fenced luau block, formatted like hover content */
+  documentation?: string;
+  deprecated: boolean;
+}
+
 export interface HoverResult {
   content: string | null;
 }
@@ -48,12 +236,104 @@ export interface SignatureResult {
       documentation?: string;
     }>;
   }>;
+  /** Overload matching the argument count so far */
+  activeSignature: number;
+  /** Argument under the cursor (method calls don't count self) */
+  activeParameter: number;
+}
+
+export type DumpFormatName = 'vm' | 'ir' | 'x64' | 'a64';
+
+/** Dump formats in outputFormat order (luau_dump_bytecode) */
+export const DUMP_FORMATS: DumpFormatName[] = ['vm', 'ir', 'x64', 'a64'];
+
+/** luau_dump_all mask bit requesting lowering stats for the requested codegen formats */
+export const DUMP_STATS_BIT = 1 << 4;
+
+/** Codegen lowering stats for one function (each function is lowered on its own) */
+export interface FunctionLoweringStats {
+  id: number;
+  name: string;
+  line: number;
+  bytecodeInstructions: number;
+  irInstructions: number;
+  asmInstructions: number;
+  asmBytes: number;
+  blocksPreOpt: number;
+  blocksPostOpt: number;
+  maxBlockInstructions: number;
+  spillsToSlot: number;
+  spillsToRestore: number;
+  maxSpillSlots: number;
+  /** Lowering gave up; limitsHit says which heuristics limits it reached */
+  skipped: boolean;
+  limitsHit: Array<'instructions' | 'blocks' | 'blockInstructions'>;
+  /** Opcode counts indexed by LuauOpcode, one array per loop nesting depth */
+  opcodes: number[][];
+}
+
+export interface LoweringStats {
+  target: 'x64' | 'a64';
+  /** CodegenHeuristics* limits in effect */
+  limits: { instructions: number; blocks: number; blockInstructions: number };
+  functions: FunctionLoweringStats[];
+  totals: {
+    functions: number;
+    skipped: number;
+    spillsToSlot: number;
+    spillsToRestore: number;
+    blocksPreOpt: number;
+    blocksPostOpt: number;
+    regAllocErrors: number;
+    loweringErrors: number;
+  };
+}
+
+export interface DumpResult {
+  success: boolean;
+  formats?: Partial<Record<DumpFormatName, string>>;
+  /** Per codegen format, when requested */
+  stats?: Partial<Record<Exclude<DumpFormatName, 'vm'>, LoweringStats>>;
+  error?: string;
+}
+
+export interface DumpFunction {
+  /** Bytecode function id */
+  id: number;
+  /** Empty for anonymous functions and the main chunk */
+  name: string;
+  main: boolean;
+  /** Source lines spanned by the function's code (1-based) */
+  lineStart: number;
+  lineEnd: number;
+  /** Offset of the function's code in the chunk's instruction stream */
+  instructionOffset: number;
+  instructions: number;
+}
+
+export interface DumpFunctionsResult {
+  success: boolean;
+  functions?: DumpFunction[];
+  error?: string;
 }
 
 /** The Emscripten module interface */
 export interface LuauWasmModule {
   // Execution
-  ccall(name: 'luau_execute', returnType: 'string', argTypes: ['string'], args: [string]): string;
+  ccall(name: 'luau_execute', returnType: 'string', argTypes: ['string', 'number', 'number'], args: [string, number, number]): string;
+  ccall(name: 'luau_execute', returnType: 'number', argTypes: ['string', 'number', 'number'], args: [string, number, number]): number;
+  ccall(name: 'luau_reset', returnType: null, argTypes: [], args: []): void;
+  ccall(name: 'luau_benchmark', returnType: 'string', argTypes: ['string', 'number', 'number', 'number', 'string'], args: [string, number, number, number, string]): string;
+  ccall(name: 'luau_set_serialize_limits', returnType: null, argTypes: ['number', 'number', 'number'], args: [number, number, number]): void;
+  ccall(name: 'luau_inspect_value', returnType: 'string', argTypes: ['number', 'string', 'number'], args: [number, string, number]): string;
+  ccall(name: 'luau_set_print_streaming', returnType: null, argTypes: ['boolean', 'number', 'number', 'number'], args: [boolean, number, number, number]): void;
+  ccall(name: 'luau_set_print_text', returnType: null, argTypes: ['boolean'], args: [boolean]): void;
+  ccall(name: 'luau_set_profiling', returnType: null, argTypes: ['boolean', 'number'], args: [boolean, number]): void;
+  ccall(name: 'luau_set_compile_options', returnType: null, argTypes: ['number', 'number', 'number', 'number', 'string', 'string', 'string'], args: [number, number, number, number, string, string, string]): void;
+  ccall(name: 'luau_set_coverage', returnType: null, argTypes: ['number'], args: [number]): void;
+  ccall(name: 'luau_set_tracing', returnType: null, argTypes: ['boolean', 'number'], args: [boolean, number]): void;
+  ccall(name: 'luau_take_trace', returnType: 'string', argTypes: [], args: []): string;
+  ccall(name: 'luau_set_memory_limit', returnType: null, argTypes: ['number'], args: [number]): void;
   
   // Module management (for require support)
   ccall(name: 'luau_add_module', returnType: null, argTypes: ['string', 'string'], args: [string, string]): void;
@@ -61,11 +341,29 @@ export interface LuauWasmModule {
   ccall(name: 'luau_get_modules', returnType: 'string', argTypes: [], args: []): string;
   ccall(name: 'luau_set_source', returnType: null, argTypes: ['string', 'string'], args: [string, string]): void;
   
-  // Analysis
-  ccall(name: 'luau_get_diagnostics', returnType: 'string', argTypes: ['string'], args: [string]): string;
-  ccall(name: 'luau_autocomplete', returnType: 'string', argTypes: ['string', 'number', 'number'], args: [string, number, number]): string;
-  ccall(name: 'luau_hover', returnType: 'string', argTypes: ['string', 'number', 'number'], args: [string, number, number]): string;
-  ccall(name: 'luau_signature_help', returnType: 'string', argTypes: ['string', 'number', 'number'], args: [string, number, number]): string;
+  // Analysis (documents are set with luau_set_source and updated with luau_apply_edit)
+  ccall(name: 'luau_apply_edit', returnType: 'number', argTypes: ['string', 'number', 'number', 'number', 'number', 'string'], args: [string, number, number, number, number, string]): number;
+  ccall(name: 'luau_document_version', returnType: 'number', argTypes: ['string'], args: [string]): number;
+  ccall(name: 'luau_get_analysis_stats', returnType: 'string', argTypes: [], args: []): string;
+  ccall(name: 'luau_set_analysis_memory_budget', returnType: null, argTypes: ['number'], args: [number]): void;
+  ccall(name: 'luau_close_document', returnType: null, argTypes: ['string'], args: [string]): void;
+  ccall(name: 'luau_memory_stats', returnType: 'string', argTypes: [], args: []): string;
+  ccall(name: 'luau_init_analysis', returnType: 'number', argTypes: [], args: []): number;
+  ccall(name: 'luau_analysis_cancelled', returnType: 'boolean', argTypes: [], args: []): boolean;
+  ccall(name: 'luau_analysis_cancel_flag', returnType: 'number', argTypes: [], args: []): number;
+  ccall(name: 'luau_set_check_time_limit', returnType: null, argTypes: ['number'], args: [number]): void;
+  ccall(name: 'luau_get_diagnostics', returnType: 'string', argTypes: ['string', 'number'], args: [string, number]): string;
+  ccall(name: 'luau_autocomplete', returnType: 'string', argTypes: ['string', 'number', 'number', 'number', 'string', 'number'], args: [string, number, number, number, string, number]): string;
+  ccall(name: 'luau_autocomplete_resolve', returnType: 'string', argTypes: ['string'], args: [string]): string;
+  ccall(name: 'luau_hover', returnType: 'string', argTypes: ['string', 'number', 'number', 'number'], args: [string, number, number, number]): string;
+  ccall(name: 'luau_signature_help', returnType: 'string', argTypes: ['string', 'number', 'number', 'number'], args: [string, number, number, number]): string;
+  
+  // Binary results: the query exports above return a pointer when the encoding is binary
+  ccall(name: 'luau_get_diagnostics', returnType: 'number', argTypes: ['string', 'number'], args: [string, number]): number;
+  ccall(name: 'luau_autocomplete', returnType: 'number', argTypes: ['string', 'number', 'number', 'number', 'string', 'number'], args: [string, number, number, number, string, number]): number;
+  ccall(name: 'luau_hover', returnType: 'number', argTypes: ['string', 'number', 'number', 'number'], args: [string, number, number, number]): number;
+  ccall(name: 'luau_set_result_encoding', returnType: null, argTypes: ['number'], args: [number]): void;
+  ccall(name: 'luau_result_size', returnType: 'number', argTypes: [], args: []): number;
     
   // Configuration
   ccall(name: 'luau_set_mode', returnType: null, argTypes: ['number'], args: [number]): void;
@@ -73,11 +371,17 @@ export interface LuauWasmModule {
   
   // Bytecode
   ccall(name: 'luau_dump_bytecode', returnType: 'string', argTypes: ['string', 'number', 'number', 'number', 'number'], args: [string, number, number, number, number]): string;
+  ccall(name: 'luau_dump_all', returnType: 'string', argTypes: ['string', 'number', 'number', 'number', 'number'], args: [string, number, number, number, number]): string;
+  ccall(name: 'luau_dump_functions', returnType: 'string', argTypes: ['string', 'number', 'number', 'number'], args: [string, number, number, number]): string;
+  ccall(name: 'luau_dump_function', returnType: 'string', argTypes: ['string', 'number', 'number', 'number', 'number', 'number'], args: [string, number, number, number, number, number]): string;
   
   // Memory
   _malloc(size: number): number;
   _free(ptr: number): void;
   
+  // Heap view, used to decode binary results in place
+  HEAPU8: Uint8Array;
+  
   // String helpers
   UTF8ToString(ptr: number): string;
   stringToUTF8(str: string, outPtr: number, maxBytes: number): void;
@@ -85,6 +389,12 @@ export interface LuauWasmModule {
 }
 
 export type CreateLuauModule = (options?: {
+  /** Stop flag polled by the VM interrupt; index 0 is non-zero when a stop is requested */
+  playgroundInterrupt?: Int32Array;
+  /** Receives JSON arrays of print records while a streaming run is in progress */
+  onPrintBatch?: (json: string) => void;
+  /** Same with the binary result encoding: a PrintBatch result, valid only during the call */
+  onPrintBatchBinary?: (ptr: number, size: number) => void;
   instantiateWasm?: (
     imports: WebAssembly.Imports,
     successCallback: (instance: WebAssembly.Instance) => void
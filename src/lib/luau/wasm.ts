@@ -3,59 +3,202 @@
  * 
  * Uses two Web Workers:
  * - Analysis worker (long-lived): LSP, bytecode, type checking - always responsive
- * - Execution worker (on-demand): code execution - can be terminated for infinite loops
+ * - Execution worker (on-demand): code execution - stopped via the VM interrupt flag,
+ *   or terminated when shared memory is unavailable
  */
 
-import { appendOutput, clearOutput, setRunning, setExecutionTime, getActiveFileContent, activeFile, getAllFiles } from '$lib/stores/playground';
-import { settings, type LuauMode, type SolverMode } from '$lib/stores/settings';
+import { appendOutput, appendOutputLines, clearOutput, setRunning, setExecutionTime, setExecutionProfile, getActiveFileContent, activeFile, getAllFiles } from '$lib/stores/playground';
+import { settings, type LuauMode, type SolverMode, type PlaygroundSettings } from '$lib/stores/settings';
+import {
+  EXECUTION_TIME_LIMIT_MS,
+  EXECUTION_MEMORY_LIMIT_BYTES,
+  PRINT_FLUSH_INTERVAL_MS,
+  PRINT_FLUSH_BYTES,
+  MAX_OUTPUT_BYTES,
+  PRINT_MAX_DEPTH,
+  PRINT_MAX_WIDTH,
+  PRINT_MAX_BYTES,
+  PROFILE_SAMPLE_INTERVAL_US,
+  BENCHMARK_ITERATIONS,
+  BENCHMARK_WARMUP,
+  ANALYSIS_CHECK_TIME_LIMIT_MS,
+  ANALYSIS_MEMORY_BUDGET_BYTES,
+  AUTOCOMPLETE_LIMIT,
+} from '$lib/constants';
+import { printLine, type LuauValue } from '$lib/utils/output';
 import { get } from 'svelte/store';
 import type { 
   ExecuteResult, 
+  ExecutionProfile,
+  ExecutionCoverage,
+  ExecutionMemoryStats,
   LuauDiagnostic,
   LuauCompletion,
+  CompletionDetails,
+  DocumentEdit,
+  AnalysisStats,
+  MemoryStats,
+  SignatureResult,
+  DumpResult,
+  DumpFormatName,
+  DumpFunction,
+  DumpFunctionsResult,
+  LoweringStats,
+  TraceEvent,
+  TraceResult,
+  BenchmarkResult,
+  BenchmarkLevelResult,
 } from './types';
-import type { WorkerRequest, WorkerResponse } from './luau.worker';
+import { DUMP_FORMATS } from './types';
+import type { WorkerRequest, WorkerResponse, WorkerEvent } from './luau.worker';
 import LuauWorker from './luau.worker?worker';
 
-declare const __wasmPromises: { luau: Promise<ArrayBuffer> } | undefined;
+// Started by index.html before any module script loads; `simd` replaces `luau` where supported
+declare const __wasmPromises: { luau?: Promise<ArrayBuffer>; simd?: Promise<ArrayBuffer> } | undefined;
 
 // Error messages for termination
 const STOPPED_ERROR = 'Execution stopped';
 const CANCELLED_ERROR = 'Cancelled';
 
+// How long a stop request waits for the VM interrupt before killing the worker
+const INTERRUPT_GRACE_MS = 500;
+
 // Convert LuauMode to numeric value for WASM
 const modeToNum = (mode: LuauMode): number =>
   mode === 'strict' ? 1 : mode === 'nocheck' ? 2 : 0;
 
-// Compiled WASM module - shared with workers to avoid recompilation
+/**
+ * Builds produced by wasm/build.sh. The SIMD build runs where the browser validates SIMD
+ * instructions; its JS module is served next to its wasm rather than bundled.
+ */
+type WasmVariant = 'baseline' | 'simd';
+
+const WASM_VARIANTS: WasmVariant[] = ['baseline', 'simd'];
+
+/**
+ * One wasm file: a variant of the full module, or of the execution-only module that the
+ * execution worker loads (VM and compiler only).
+ */
+interface WasmBuild {
+  variant: WasmVariant;
+  executionOnly: boolean;
+}
+
+const BASELINE_BUILD: WasmBuild = { variant: 'baseline', executionOnly: false };
+
+// i8x16.splat + i8x16.popcnt in a function body; validates only with SIMD support
+const SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+
+function supportsWasmSimd(): boolean {
+  try {
+    return WebAssembly.validate(SIMD_PROBE);
+  } catch {
+    return false;
+  }
+}
+
+/** `?wasm=baseline|simd` pins both workers to one build, e.g. to compare benchmarks */
+function pinnedWasmVariant(): WasmVariant | null {
+  const pinned = new URLSearchParams(location.search).get('wasm');
+  return WASM_VARIANTS.find((variant) => variant === pinned) ?? null;
+}
+
+function wasmBaseUrl(): string {
+  return new URL('./', document.baseURI).href.replace(/\/$/, '');
+}
+
+function wasmFileFor({ variant, executionOnly }: WasmBuild): string {
+  const name = executionOnly ? 'luau-execution' : 'luau';
+  return variant === 'baseline' ? name : `${name}-${variant}`;
+}
+
+// Only the full baseline build's JS module is bundled (src/lib/luau/luau-module.js)
+function moduleUrlFor(build: WasmBuild): string | undefined {
+  return build.variant === 'baseline' && !build.executionOnly
+    ? undefined
+    : `${wasmBaseUrl()}/wasm/${wasmFileFor(build)}.js`;
+}
+
+// Compiled WASM modules per file - shared with workers to avoid recompilation
 // WebAssembly.Module is structured-clonable, so workers get the same compiled code
-let compiledWasmModule: WebAssembly.Module | null = null;
-let wasmModuleLoading: Promise<WebAssembly.Module> | null = null;
+const compiledWasmModules = new Map<string, Promise<WebAssembly.Module>>();
 
 /**
  * Get the compiled WASM module, using preloaded promise from index.html or fetching once.
  * WebAssembly.Module is structured-clonable and can be sent to workers without copying
  * the entire compiled code - workers can instantiate directly from the shared module.
  */
-async function getCompiledWasmModule(): Promise<WebAssembly.Module> {
-  if (!compiledWasmModule) {
-    if (!wasmModuleLoading) {
-      wasmModuleLoading = (async () => {
-        let buffer: ArrayBuffer;
-        if (typeof __wasmPromises !== 'undefined') {
-          buffer = await __wasmPromises.luau;
-        } else {
-          const baseUrl = new URL('./', document.baseURI).href.replace(/\/$/, '');
-          buffer = await fetch(`${baseUrl}/wasm/luau.wasm`).then(r => r.arrayBuffer());
-        }
-        // Compile once - the compiled module can be shared with workers
-        compiledWasmModule = await WebAssembly.compile(buffer);
-        return compiledWasmModule;
-      })();
+async function getCompiledWasmModule(build: WasmBuild = BASELINE_BUILD): Promise<WebAssembly.Module> {
+  const file = `${wasmFileFor(build)}.wasm`;
+  let loading = compiledWasmModules.get(file);
+  if (!loading) {
+    loading = (async () => {
+      let preloaded: Promise<ArrayBuffer> | undefined;
+      if (typeof __wasmPromises !== 'undefined' && !build.executionOnly) {
+        preloaded = build.variant === 'baseline' ? __wasmPromises.luau : __wasmPromises.simd;
+      }
+      let buffer: ArrayBuffer;
+      if (preloaded) {
+        buffer = await preloaded;
+      } else {
+        const response = await fetch(`${wasmBaseUrl()}/wasm/${file}`);
+        if (!response.ok) throw new Error(`Failed to fetch ${file}: ${response.status}`);
+        buffer = await response.arrayBuffer();
+      }
+      // Compile once - the compiled module can be shared with workers
+      return WebAssembly.compile(buffer);
+    })();
+    // A failed load can be retried
+    loading.catch(() => compiledWasmModules.delete(file));
+    compiledWasmModules.set(file, loading);
+  }
+  return loading;
+}
+
+/** The first of `candidates` that loads; if none does, the full baseline build */
+async function firstLoadableBuild(candidates: WasmBuild[]): Promise<WasmBuild> {
+  for (const build of candidates) {
+    try {
+      await getCompiledWasmModule(build);
+      return build;
+    } catch (error) {
+      console.warn(`[Luau] ${wasmFileFor(build)}.wasm unavailable:`, error);
     }
-    await wasmModuleLoading;
   }
-  return compiledWasmModule!;
+  return BASELINE_BUILD;
+}
+
+/** Variants this page can run, most preferred first, always ending with baseline */
+function variantCandidates(preferred: WasmVariant[]): WasmVariant[] {
+  const pinned = pinnedWasmVariant();
+  const supported = (pinned ? [pinned] : preferred).filter((variant) => variant !== 'simd' || supportsWasmSimd());
+  return supported.includes('baseline') ? supported : [...supported, 'baseline'];
+}
+
+/**
+ * Builds each worker prefers, resolved once per page: analysis the SIMD build; execution
+ * the execution-only module (no analysis or codegen exports), SIMD first.
+ */
+let analysisBuild: Promise<WasmBuild> | null = null;
+let executionBuild: Promise<WasmBuild> | null = null;
+
+function resolveAnalysisBuild(): Promise<WasmBuild> {
+  analysisBuild ??= firstLoadableBuild(
+    variantCandidates(['simd']).map((variant) => ({ variant, executionOnly: false }))
+  );
+  return analysisBuild;
+}
+
+function resolveExecutionBuild(): Promise<WasmBuild> {
+  const variants = variantCandidates(['simd']);
+  // Deployments without the execution-only module fall back to the full one
+  executionBuild ??= firstLoadableBuild([
+    ...variants.map((variant) => ({ variant, executionOnly: true })),
+    ...variants.map((variant) => ({ variant, executionOnly: false })),
+  ]);
+  return executionBuild;
 }
 
 // ============================================================================
@@ -71,6 +214,9 @@ interface WorkerManager {
     reject: (error: Error) => void;
   }>;
   requestIdCounter: number;
+  onEvent: ((event: WorkerEvent) => void) | null;
+  /** Analysis cancellation flag inside the worker's wasm memory, when that memory is shared */
+  cancelFlag: Int8Array | null;
 }
 
 function createWorkerManager(): WorkerManager {
@@ -80,13 +226,20 @@ function createWorkerManager(): WorkerManager {
     readyPromise: null,
     pendingRequests: new Map(),
     requestIdCounter: 0,
+    onEvent: null,
+    cancelFlag: null,
   };
 }
 
 function setupWorkerHandlers(manager: WorkerManager, name: string): void {
   if (!manager.worker) return;
   
-  manager.worker.onmessage = (e: MessageEvent<WorkerResponse & { requestId: string }>) => {
+  manager.worker.onmessage = (e: MessageEvent<(WorkerResponse & { requestId: string }) | WorkerEvent>) => {
+    if (!('requestId' in e.data)) {
+      manager.onEvent?.(e.data);
+      return;
+    }
+    
     const { requestId, ...response } = e.data;
     
     const pending = manager.pendingRequests.get(requestId);
@@ -114,7 +267,12 @@ function rejectAllPending(manager: WorkerManager, error: Error): void {
   manager.pendingRequests.clear();
 }
 
-async function initializeWorker(manager: WorkerManager, wasmModule: WebAssembly.Module): Promise<void> {
+async function initializeWorker(
+  manager: WorkerManager,
+  wasmModule: WebAssembly.Module,
+  interruptFlag?: Int32Array,
+  moduleUrl?: string
+): Promise<void> {
   const requestId = `init_${manager.requestIdCounter++}`;
   
   return new Promise((resolve, reject) => {
@@ -124,8 +282,12 @@ async function initializeWorker(manager: WorkerManager, wasmModule: WebAssembly.
     }, 10000);
     
     manager.pendingRequests.set(requestId, {
-      resolve: () => {
+      resolve: (response) => {
         clearTimeout(timer);
+        if (response.type === 'ready' && response.cancelFlag) {
+          const { memory, offset } = response.cancelFlag;
+          manager.cancelFlag = new Int8Array(memory, offset, 1);
+        }
         resolve();
       },
       reject: (err) => {
@@ -135,7 +297,7 @@ async function initializeWorker(manager: WorkerManager, wasmModule: WebAssembly.
     });
     
     manager.worker!.postMessage(
-      { type: 'init', wasmModule, requestId } satisfies WorkerRequest & { requestId: string }
+      { type: 'init', wasmModule, interruptFlag, moduleUrl, requestId } satisfies WorkerRequest & { requestId: string }
     );
   });
 }
@@ -167,6 +329,7 @@ async function sendToWorker<K extends WorkerRequest['type']>(
 function terminateWorker(manager: WorkerManager, errorMessage: string = STOPPED_ERROR): void {
   manager.readyPromise = null;
   manager.ready = false;
+  manager.cancelFlag = null;
   
   if (manager.worker) {
     manager.worker.terminate();
@@ -185,7 +348,9 @@ async function loadWorker(
   name: string,
   options?: { 
     checkTerminated?: boolean;
-    postInit?: () => Promise<void>;
+    interruptFlag?: Int32Array;
+    build?: () => Promise<WasmBuild>;
+    postInit?: (build: WasmBuild) => Promise<void>;
   }
 ): Promise<void> {
   if (manager.ready && manager.worker) {
@@ -196,21 +361,23 @@ async function loadWorker(
     return manager.readyPromise;
   }
 
-  const { checkTerminated = false, postInit } = options ?? {};
+  const { checkTerminated = false, interruptFlag, build: selectBuild, postInit } = options ?? {};
 
   manager.readyPromise = (async () => {
     try {
-      const modulePromise = getCompiledWasmModule();
+      const buildPromise = selectBuild?.() ?? Promise.resolve(BASELINE_BUILD);
+      const modulePromise = buildPromise.then((build) => getCompiledWasmModule(build));
       manager.worker = new LuauWorker();
       setupWorkerHandlers(manager, name);
       
+      const build = await buildPromise;
       const wasmModule = await modulePromise;
       
       if (checkTerminated && !manager.worker) {
         throw new Error(STOPPED_ERROR);
       }
       
-      await initializeWorker(manager, wasmModule);
+      await initializeWorker(manager, wasmModule, interruptFlag, moduleUrlFor(build));
       
       if (checkTerminated && !manager.worker) {
         throw new Error(STOPPED_ERROR);
@@ -218,7 +385,7 @@ async function loadWorker(
       
       manager.ready = true;
       
-      await postInit?.();
+      await postInit?.(build);
     } catch (error) {
       manager.readyPromise = null;
       manager.ready = false;
@@ -241,11 +408,25 @@ const analysis = createWorkerManager();
 
 async function loadAnalysisWorker(): Promise<void> {
   return loadWorker(analysis, 'Analysis', {
+    build: resolveAnalysisBuild,
     postInit: async () => {
+      // A fresh worker holds no documents yet
+      analysisDocuments.clear();
       const currentSettings = get(settings);
       await sendToWorker(analysis, 'setMode', { mode: modeToNum(currentSettings.mode) });
       await sendToWorker(analysis, 'setSolver', { isNew: currentSettings.solver === 'new' });
+      await sendToWorker(analysis, 'setCheckTimeLimit', { timeLimitMs: ANALYSIS_CHECK_TIME_LIMIT_MS });
+      await sendToWorker(analysis, 'setMemoryBudget', { budgetBytes: ANALYSIS_MEMORY_BUDGET_BYTES });
+      // Dumps take their levels per request but share the rest of execution's options
+      await sendToWorker(analysis, 'setCompileOptions', compileOptionsFor(currentSettings, 0));
+      if (tracingEnabled) {
+        await sendToWorker(analysis, 'setTracing', { enabled: true, pid: ANALYSIS_TRACE_PID });
+      }
+      // Pay the builtin environment cost before the first keystroke needs it
+      await sendToWorker(analysis, 'initAnalysis', {});
       initSettingsSync();
+      // Fetch and compile the execution module while the page is idle, before the first run
+      void resolveExecutionBuild();
     }
   });
 }
@@ -258,18 +439,166 @@ async function sendAnalysisRequest<K extends WorkerRequest['type']>(
   return sendToWorker(analysis, type, params);
 }
 
+/**
+ * Abort the typecheck the analysis worker is running, if the worker's memory is shared.
+ * None of the wasm/build.sh builds share it, so the check runs to completion, bounded by
+ * the time limit.
+ */
+function cancelAnalysis(): void {
+  if (analysis.cancelFlag && analysis.pendingRequests.size > 0) {
+    Atomics.store(analysis.cancelFlag, 0, 1);
+  }
+}
+
+// Editor queries are latest-wins. The analysis worker is sent one editor query at a time,
+// so queries wait here rather than in the worker's message queue, where a newer one could
+// not replace them: a query superseded by a newer one of its kind while waiting is dropped
+// without reaching the worker. A newer query also cancels the running one of its kind.
+type EditorQuery = 'getDiagnostics' | 'autocomplete' | 'resolveCompletion' | 'hover' | 'signatureHelp';
+
+const latestEditorQuery = new Map<EditorQuery, number>();
+let editorQueryInFlight: { type: EditorQuery; request: Promise<unknown> } | null = null;
+
+/**
+ * Send an editor query, or resolve to null if a newer query of the same kind
+ * was issued before this one could be sent.
+ */
+async function sendEditorQuery<K extends EditorQuery>(
+  type: K,
+  params: () => Promise<Omit<Extract<WorkerRequest, { type: K }>, 'type'>>
+): Promise<ResponseForRequest<K> | null> {
+  const seq = (latestEditorQuery.get(type) ?? 0) + 1;
+  latestEditorQuery.set(type, seq);
+  
+  while (editorQueryInFlight) {
+    if (editorQueryInFlight.type === type) cancelAnalysis();
+    await editorQueryInFlight.request.catch(() => {});
+    if (seq !== latestEditorQuery.get(type)) return null;
+  }
+  
+  const request = params().then((p) => sendAnalysisRequest(type, p));
+  const inFlight = { type, request };
+  editorQueryInFlight = inFlight;
+  try {
+    return await request;
+  } finally {
+    if (editorQueryInFlight === inFlight) editorQueryInFlight = null;
+  }
+}
+
+// ============================================================================
+// Analysis Documents - Incremental source sync for the analysis worker
+// ============================================================================
+
+// Text and document version of each file as the analysis worker holds it.
+// Edits made in the editor are forwarded as ranges; other changes resend the file.
+const analysisDocuments = new Map<string, { text: string; version: number }>();
+
+/**
+ * Send files whose text differs from the worker's copy and close the ones that
+ * were deleted, then return the current version of `name` for a query against it.
+ */
+async function syncDocument(name: string): Promise<number> {
+  const files = getAllFiles();
+  const changed: Record<string, string> = {};
+  let hasChanges = false;
+  for (const [file, text] of Object.entries(files)) {
+    if (analysisDocuments.get(file)?.text !== text) {
+      changed[file] = text;
+      hasChanges = true;
+    }
+  }
+  
+  const closed = [...analysisDocuments.keys()].filter((file) => !(file in files));
+  if (closed.length > 0) {
+    for (const file of closed) analysisDocuments.delete(file);
+    await sendAnalysisRequest('closeDocuments', { names: closed });
+  }
+  
+  if (hasChanges) {
+    const { versions } = await sendAnalysisRequest('setDocuments', { sources: changed });
+    for (const [file, version] of Object.entries(versions)) {
+      analysisDocuments.set(file, { text: changed[file], version });
+    }
+  }
+  
+  return analysisDocuments.get(name)?.version ?? -1;
+}
+
+/**
+ * Forward editor changes to the analysis worker without resending the document.
+ * `text` is the document after the edits; edits are applied in order, each against the
+ * result of the previous one (0-based lines, UTF-8 byte columns).
+ */
+export function applyDocumentEdits(name: string, edits: DocumentEdit[], text: string): void {
+  const doc = analysisDocuments.get(name);
+  if (!doc || !analysis.ready || edits.length === 0) return; // the next query resends the file
+  
+  // Every applied edit bumps the version by one, so queries can use it right away
+  const expectedVersion = doc.version + edits.length;
+  doc.text = text;
+  doc.version = expectedVersion;
+  
+  // Whatever is being checked now is for text that no longer exists
+  cancelAnalysis();
+  
+  sendToWorker(analysis, 'applyEdits', { name, edits })
+    .then(({ version }) => {
+      if (version !== expectedVersion) analysisDocuments.delete(name);
+    })
+    .catch(() => analysisDocuments.delete(name));
+}
+
 // ============================================================================
 // Execution Worker - On-demand for code execution (can be terminated)
 // ============================================================================
 
 const execution = createWorkerManager();
 
+// Stop flag shared with the execution worker, polled by the VM interrupt.
+// SharedArrayBuffer needs cross-origin isolation: vite's dev and preview servers send the
+// headers, and on hosts that can't, index.html installs public/coi-serviceworker.js to add
+// them. Pages that still aren't isolated (e.g. embedded elsewhere) stop by terminating.
+const executionInterrupt: Int32Array | null =
+  typeof SharedArrayBuffer !== 'undefined' && globalThis.crossOriginIsolated
+    ? new Int32Array(new SharedArrayBuffer(4))
+    : null;
+
+// The execute request currently running in the worker, if any
+let inFlightExecution: Promise<unknown> | null = null;
+let stopRequested = false;
+// Set when a run hit the memory cap: the next run first rebuilds the template state,
+// releasing the blocks its allocator pooled (inspect handles stay valid until then)
+let resetBeforeNextRun = false;
+// Profiler and coverage settings last sent to the execution worker (a fresh worker starts disabled)
+let executionProfiling = false;
+let executionCoverage = 0;
+
 async function loadExecutionWorker(): Promise<void> {
   return loadWorker(execution, 'Execution', {
     checkTerminated: true,
+    interruptFlag: executionInterrupt ?? undefined,
+    build: resolveExecutionBuild,
     postInit: async () => {
-      const currentSettings = get(settings);
-      await sendToWorker(execution, 'setMode', { mode: modeToNum(currentSettings.mode) });
+      executionProfiling = false;
+      executionCoverage = 0;
+      await sendToWorker(execution, 'setCompileOptions', compileOptionsFor(get(settings), 0));
+      if (tracingEnabled) {
+        await sendToWorker(execution, 'setTracing', { enabled: true, pid: EXECUTION_TRACE_PID });
+      }
+      await sendToWorker(execution, 'setPrintText', { enabled: false });
+      await sendToWorker(execution, 'setPrintStreaming', {
+        enabled: true,
+        flushIntervalMs: PRINT_FLUSH_INTERVAL_MS,
+        flushBytes: PRINT_FLUSH_BYTES,
+        maxOutputBytes: MAX_OUTPUT_BYTES,
+      });
+      await sendToWorker(execution, 'setMemoryLimit', { limitBytes: EXECUTION_MEMORY_LIMIT_BYTES });
+      await sendToWorker(execution, 'setSerializeLimits', {
+        maxDepth: PRINT_MAX_DEPTH,
+        maxWidth: PRINT_MAX_WIDTH,
+        maxBytes: PRINT_MAX_BYTES,
+      });
     }
   });
 }
@@ -300,7 +629,33 @@ export async function loadLuauWasm(): Promise<void> {
 }
 
 /**
- * Stop any running execution by terminating the execution worker.
+ * Interrupt the in-flight execution, keeping the worker and its warm VM state.
+ * Falls back to terminating the worker if the interrupt flag is unavailable
+ * or the script doesn't reach a safepoint within the grace period.
+ */
+async function interruptExecution(errorMessage: string): Promise<void> {
+  const running = inFlightExecution;
+  
+  if (!executionInterrupt || !running) {
+    terminateWorker(execution, errorMessage);
+    return;
+  }
+  
+  stopRequested = true;
+  Atomics.store(executionInterrupt, 0, 1);
+  
+  const stopped = await Promise.race([
+    running.then(() => true, () => true),
+    new Promise<boolean>((resolve) => setTimeout(() => resolve(false), INTERRUPT_GRACE_MS)),
+  ]);
+  
+  if (!stopped) {
+    terminateWorker(execution, errorMessage);
+  }
+}
+
+/**
+ * Stop any running execution.
  * The analysis worker stays alive for LSP/bytecode operations.
  */
 export function stopExecution(): void {
@@ -308,17 +663,48 @@ export function stopExecution(): void {
     return; // Nothing to stop
   }
   
-  terminateWorker(execution);
+  // Invalidate the current run so its result is not displayed
+  currentRunId++;
+  void interruptExecution(STOPPED_ERROR);
   setRunning(false);
   appendOutput({ type: 'warn', text: STOPPED_ERROR });
 }
 
+/**
+ * Send a request that runs Luau code, so stopExecution can interrupt it through the VM.
+ */
+async function sendInterruptibleRequest<K extends 'execute' | 'benchmark'>(
+  type: K,
+  params: Omit<Extract<WorkerRequest, { type: K }>, 'type'>
+): Promise<ResponseForRequest<K>> {
+  if (resetBeforeNextRun) {
+    resetBeforeNextRun = false;
+    await resetExecution();
+  }
+  if (executionInterrupt) {
+    Atomics.store(executionInterrupt, 0, 0);
+  }
+  stopRequested = false;
+  
+  const request = sendExecutionRequest(type, params);
+  inFlightExecution = request;
+  return request.finally(() => {
+    if (inFlightExecution === request) inFlightExecution = null;
+  });
+}
+
 /**
  * Execute Luau code using the execution worker.
  */
 export async function executeCode(code: string): Promise<{ result: ExecuteResult; elapsed: number }> {
   try {
-    const response = await sendExecutionRequest('execute', { code });
+    const response = await sendInterruptibleRequest('execute', { code, timeLimit: EXECUTION_TIME_LIMIT_MS });
+    if (response.result.memory?.outOfMemory) resetBeforeNextRun = true;
+    
+    // A user stop is reported by stopExecution, not as a runtime error
+    if (response.result.interrupted && stopRequested) {
+      return { result: { success: false, output: '', error: undefined }, elapsed: response.elapsed };
+    }
     return { result: response.result, elapsed: response.elapsed };
   } catch (error) {
     // Silently handle stopped/cancelled - no error to report
@@ -335,15 +721,40 @@ export async function executeCode(code: string): Promise<{ result: ExecuteResult
 }
 
 /**
- * Get diagnostics for code using the analysis worker.
+ * Expand a printed value that was truncated by the serialization budgets.
+ * `path` walks from the handle's table with typed keys: `s:name` and `n:1` for string and
+ * number keys, `i:3` for the third entry in iteration order (keys of other types).
+ * Handles are only valid until the next run in the same execution worker.
  */
-export async function getDiagnostics(code: string): Promise<{ diagnostics: LuauDiagnostic[]; elapsed: number }> {
+export async function inspectValue(handle: number, path: string[] = [], offset: number = 0): Promise<LuauValue | null> {
+  if (!execution.ready) return null;
+  
   try {
-    const allFiles = getAllFiles();
-    await sendAnalysisRequest('registerSources', { sources: allFiles });
-    
-    const response = await sendAnalysisRequest('getDiagnostics', { code });
-    return { diagnostics: response.result.diagnostics, elapsed: response.elapsed };
+    const response = await sendToWorker(execution, 'inspectValue', { handle, path, offset });
+    return response.result.success ? response.result.value ?? null : null;
+  } catch (error) {
+    console.error('[Luau] Inspect error:', error);
+    return null;
+  }
+}
+
+/**
+ * Get diagnostics for a project file using the analysis worker.
+ * Only files changed since the last check (and the files that require them) are rechecked.
+ * Editor requests are latest-wins; `cancelled` is set when a newer request superseded this one.
+ */
+export async function getDiagnostics(
+  name: string,
+  options: { latestWins?: boolean } = {}
+): Promise<{ diagnostics: LuauDiagnostic[]; elapsed: number; cancelled?: boolean }> {
+  const { latestWins = true } = options;
+  try {
+    const params = async () => ({ name, version: await syncDocument(name) });
+    const response = latestWins
+      ? await sendEditorQuery('getDiagnostics', params)
+      : await sendAnalysisRequest('getDiagnostics', await params());
+    if (!response) return { diagnostics: [], elapsed: 0, cancelled: true };
+    return { diagnostics: response.result.diagnostics, elapsed: response.elapsed, cancelled: response.result.cancelled };
   } catch (error) {
     console.error('[Luau] Diagnostics error:', error);
     return { diagnostics: [], elapsed: 0 };
@@ -351,31 +762,157 @@ export async function getDiagnostics(code: string): Promise<{ diagnostics: LuauD
 }
 
 /**
- * Get autocomplete suggestions using the analysis worker.
+ * Get autocomplete suggestions using the analysis worker, filtered by the identifier
+ * typed before the cursor and ranked best first. At most `limit` items are returned;
+ * a full page means more may match, so query again as the prefix grows.
+ * Positions are 0-based lines and UTF-8 byte columns.
  */
-export async function getAutocomplete(code: string, line: number, col: number): Promise<LuauCompletion[]> {
+export async function getAutocomplete(
+  name: string,
+  line: number,
+  col: number,
+  prefix: string,
+  limit: number = AUTOCOMPLETE_LIMIT
+): Promise<LuauCompletion[]> {
   try {
-    const response = await sendAnalysisRequest('autocomplete', { code, line, col });
-    return response.result.items;
+    const response = await sendEditorQuery('autocomplete', async () => ({ name, version: await syncDocument(name), line, col, prefix, limit }));
+    return response?.result.items ?? [];
   } catch (error) {
     console.error('[Luau] Autocomplete error:', error);
     return [];
   }
 }
 
+/**
+ * Full details (complete type, documentation) of an item from the last autocomplete list.
+ * Null once the document has changed since that list.
+ */
+export async function resolveCompletion(label: string): Promise<CompletionDetails | null> {
+  try {
+    const response = await sendEditorQuery('resolveCompletion', async () => ({ label }));
+    return response?.result ?? null;
+  } catch (error) {
+    console.error('[Luau] Completion resolve error:', error);
+    return null;
+  }
+}
+
 /**
  * Get hover information using the analysis worker.
+ * Positions are 0-based lines and UTF-8 byte columns.
  */
-export async function getHover(code: string, line: number, col: number): Promise<string | null> {
+export async function getHover(name: string, line: number, col: number): Promise<string | null> {
   try {
-    const response = await sendAnalysisRequest('hover', { code, line, col });
-    return response.result.content;
+    const response = await sendEditorQuery('hover', async () => ({ name, version: await syncDocument(name), line, col }));
+    return response?.result.content ?? null;
   } catch (error) {
     console.error('[Luau] Hover error:', error);
     return null;
   }
 }
 
+/**
+ * Get the signatures of the call around a position using the analysis worker.
+ * Positions are 0-based lines and UTF-8 byte columns.
+ */
+export async function getSignatureHelp(name: string, line: number, col: number): Promise<SignatureResult | null> {
+  try {
+    const response = await sendEditorQuery('signatureHelp', async () => ({ name, version: await syncDocument(name), line, col }));
+    return response?.result ?? null;
+  } catch (error) {
+    console.error('[Luau] Signature help error:', error);
+    return null;
+  }
+}
+
+/**
+ * Shared check cache hit/miss counts and analysis startup timings, for telemetry.
+ */
+export async function getAnalysisStats(): Promise<AnalysisStats | null> {
+  try {
+    const response = await sendAnalysisRequest('getAnalysisStats', {});
+    return response.result;
+  } catch (error) {
+    console.error('[Luau] Failed to get analysis stats:', error);
+    return null;
+  }
+}
+
+// ============================================================================
+// Tracing
+// ============================================================================
+
+// Trace-event process ids of the workers; spans of both land in one trace
+const ANALYSIS_TRACE_PID = 1;
+const EXECUTION_TRACE_PID = 2;
+
+// Applied to workers started later as well
+let tracingEnabled = false;
+
+/**
+ * Record per-phase spans in both workers until disabled.
+ */
+export async function setTracing(enabled: boolean): Promise<void> {
+  tracingEnabled = enabled;
+  
+  const workers: Array<[WorkerManager, number]> = [[analysis, ANALYSIS_TRACE_PID], [execution, EXECUTION_TRACE_PID]];
+  await Promise.all(workers.map(async ([manager, pid]) => {
+    if (!manager.ready) return;
+    try {
+      await sendToWorker(manager, 'setTracing', { enabled, pid });
+    } catch (error) {
+      console.error('[Luau] Failed to set tracing:', error);
+    }
+  }));
+}
+
+/**
+ * Drain the spans recorded by both workers as one Chrome trace, on this thread's
+ * performance.now() timeline so it lines up with a browser profile of the page.
+ */
+export async function takeTrace(): Promise<TraceResult> {
+  const trace: TraceResult = { traceEvents: [], droppedEvents: 0 };
+  
+  const workers: Array<[WorkerManager, number, string]> = [
+    [analysis, ANALYSIS_TRACE_PID, 'Luau analysis worker'],
+    [execution, EXECUTION_TRACE_PID, 'Luau execution worker'],
+  ];
+  for (const [manager, pid, name] of workers) {
+    if (!manager.ready) continue;
+    
+    let response: ResponseForRequest<'takeTrace'>;
+    try {
+      response = await sendToWorker(manager, 'takeTrace', {});
+    } catch (error) {
+      console.error('[Luau] Failed to take trace:', error);
+      continue;
+    }
+    
+    const shiftUs = (response.timeOrigin - performance.timeOrigin) * 1000;
+    const metadata: TraceEvent = { name: 'process_name', ph: 'M', ts: 0, pid, tid: 1, args: { name } };
+    trace.traceEvents.push(metadata);
+    for (const event of response.result.traceEvents) {
+      trace.traceEvents.push({ ...event, ts: event.ts + shiftUs });
+    }
+    trace.droppedEvents += response.result.droppedEvents;
+  }
+  
+  return trace;
+}
+
+/**
+ * Type arena sizes per module and wasm heap usage of the analysis worker.
+ */
+export async function getMemoryStats(): Promise<MemoryStats | null> {
+  try {
+    const response = await sendAnalysisRequest('getMemoryStats', {});
+    return response.result;
+  } catch (error) {
+    console.error('[Luau] Failed to get memory stats:', error);
+    return null;
+  }
+}
+
 /**
  * Get list of available modules for autocomplete.
  */
@@ -395,10 +932,6 @@ export async function getAvailableModules(): Promise<string[]> {
 export async function setLuauMode(mode: LuauMode): Promise<void> {
   try {
     await sendAnalysisRequest('setMode', { mode: modeToNum(mode) });
-    // Also update execution worker if it's running
-    if (execution.ready) {
-      await sendToWorker(execution, 'setMode', { mode: modeToNum(mode) });
-    }
   } catch (error) {
     console.error('[Luau] Failed to set mode:', error);
   }
@@ -410,16 +943,30 @@ export async function setLuauMode(mode: LuauMode): Promise<void> {
 export async function setLuauSolver(solver: SolverMode): Promise<void> {
   try {
     await sendAnalysisRequest('setSolver', { isNew: solver === 'new' });
-    // Also update execution worker if it's running
-    if (execution.ready) {
-      await sendToWorker(execution, 'setSolver', { isNew: solver === 'new' });
-    }
   } catch (error) {
     console.error('[Luau] Failed to set solver:', error);
   }
 }
 
 // Subscribe to settings changes and sync to WASM
+/**
+ * Compile options for executed code: the bytecode view's levels, so both show the same code.
+ */
+function compileOptionsFor(
+  current: PlaygroundSettings,
+  coverageLevel: number
+): Omit<Extract<WorkerRequest, { type: 'setCompileOptions' }>, 'type'> {
+  return {
+    optimizationLevel: current.optimizationLevel,
+    debugLevel: current.debugLevel,
+    typeInfoLevel: 0,
+    coverageLevel,
+    vectorLib: '',
+    vectorCtor: '',
+    vectorType: '',
+  };
+}
+
 let settingsUnsubscribe: (() => void) | null = null;
 
 export function initSettingsSync(): void {
@@ -430,16 +977,50 @@ export function initSettingsSync(): void {
       await setLuauMode(newSettings.mode);
       await setLuauSolver(newSettings.solver);
     }
+    if (execution.ready) {
+      try {
+        await sendToWorker(execution, 'setCompileOptions', compileOptionsFor(newSettings, executionCoverage));
+      } catch (error) {
+        console.error('[Luau] Failed to set compile options:', error);
+      }
+    }
   });
 }
 
 // Run ID to track and cancel specific runs
 let currentRunId = 0;
 
+/**
+ * One-line summary of a profile for the output panel.
+ */
+function describeProfile(profile: ExecutionProfile): string {
+  const hottest = profile.functions.find((fn) => fn.self > 0);
+  const summary = `Profile: ${profile.samples} sample${profile.samples !== 1 ? 's' : ''} over ${profile.durationMs.toFixed(1)}ms`;
+  if (!hottest) return summary;
+  
+  const share = ((hottest.self / profile.samples) * 100).toFixed(1);
+  return `${summary}, hottest ${hottest.name} (${hottest.source}:${hottest.line}) ${share}% self`;
+}
+
+/**
+ * Covered/executable line summary per chunk for the output panel.
+ */
+function describeCoverage(coverage: ExecutionCoverage): string {
+  const files = Object.entries(coverage.files).map(([name, file]) => {
+    const percent = file.total > 0 ? ((file.covered / file.total) * 100).toFixed(0) : '100';
+    return `${name} ${file.covered}/${file.total} lines (${percent}%)`;
+  });
+  return `Coverage: ${files.join(', ')}`;
+}
+
 /**
  * Run the active file and display output.
+ * @param options.profile Sample the call stack during the run and show line heat in the editor
+ * @param options.coverage Compile with statement and expression coverage and report hit lines
  */
-export async function runCode(): Promise<void> {
+export async function runCode(options: { profile?: boolean; coverage?: boolean } = {}): Promise<void> {
+  const profile = options.profile ?? false;
+  const coverage = options.coverage ? 2 : 0;
   const myRunId = ++currentRunId;
   
   // Set running state before termination to avoid brief isRunning=false gap
@@ -447,9 +1028,11 @@ export async function runCode(): Promise<void> {
   clearOutput();
   setExecutionTime(null);
   
-  // Stop any existing execution silently (not user-initiated)
-  if (execution.worker) {
-    terminateWorker(execution, CANCELLED_ERROR);
+  // Stop any in-flight execution silently (not user-initiated)
+  // An idle worker is kept so its cached VM state is reused for this run
+  if (execution.worker && execution.pendingRequests.size > 0) {
+    await interruptExecution(CANCELLED_ERROR);
+    if (currentRunId !== myRunId) return;
   }
 
   try {
@@ -462,29 +1045,55 @@ export async function runCode(): Promise<void> {
     const allFiles = getAllFiles();
     await sendExecutionRequest('registerModules', { modules: allFiles });
     
+    if (profile !== executionProfiling) {
+      await sendExecutionRequest('setProfiling', { enabled: profile, intervalUs: PROFILE_SAMPLE_INTERVAL_US });
+      executionProfiling = profile;
+    }
+    if (coverage !== executionCoverage) {
+      await sendExecutionRequest('setCoverage', { level: coverage });
+      executionCoverage = coverage;
+    }
+    
     if (currentRunId !== myRunId) return;
     
+    // Streamed print batches arrive while the run is still in progress
+    execution.onEvent = (event) => {
+      if (event.type === 'printBatch' && currentRunId === myRunId) {
+        appendOutputLines(event.prints.map(printLine));
+      }
+    };
+    
     const { result, elapsed } = await executeCode(code);
     
     if (currentRunId !== myRunId) return;
     
     setExecutionTime(elapsed);
+    setExecutionProfile(fileName, result.profile ?? null);
     
     if (result.prints && result.prints.length > 0) {
-      result.prints.forEach((values) => {
-        appendOutput({ type: 'log', text: '', values });
-      });
+      appendOutputLines(result.prints.map(printLine));
     } else if (result.output) {
       result.output.split('\n').forEach((line) => {
         appendOutput({ type: 'log', text: line });
       });
     }
     
+    if (result.droppedPrints) {
+      appendOutput({ type: 'warn', text: `Output truncated: ${result.droppedPrints} print call${result.droppedPrints !== 1 ? 's' : ''} dropped` });
+    }
+    
     if (!result.success && result.error) {
       result.error.split('\n').forEach((line) => {
         appendOutput({ type: 'error', text: line });
       });
     }
+    
+    if (result.profile) {
+      appendOutput({ type: 'log', text: describeProfile(result.profile) });
+    }
+    if (result.coverage) {
+      appendOutput({ type: 'log', text: describeCoverage(result.coverage) });
+    }
   } catch (error) {
     if (currentRunId === myRunId && error instanceof Error && 
         error.message !== STOPPED_ERROR && error.message !== CANCELLED_ERROR) {
@@ -496,15 +1105,96 @@ export async function runCode(): Promise<void> {
   } finally {
     if (currentRunId === myRunId) {
       setRunning(false);
-      // Terminate execution worker to free memory when not running
-      // Worker startup is fast enough (~20-50ms) to recreate on demand
-      if (execution.worker) {
-        terminateWorker(execution, 'Execution complete');
-      }
     }
   }
 }
 
+function formatBenchmarkLevel(level: BenchmarkLevelResult): string {
+  const ms = (value: number | undefined) => `${(value ?? 0).toFixed(3)}ms`;
+  return `O${level.optimizationLevel}: median ${ms(level.medianMs)}, min ${ms(level.minMs)}, p95 ${ms(level.p95Ms)}, ` +
+    `stddev ${ms(level.stddevMs)}, ${Math.round(level.allocationsPerIteration ?? 0)} allocs ` +
+    `(${Math.round(level.allocatedBytesPerIteration ?? 0)} bytes) and ${(level.gcCyclesPerIteration ?? 0).toFixed(2)} GC cycles per iteration`;
+}
+
+/**
+ * Benchmark the active file in the execution worker and display the timings.
+ * @param options.optimizationLevel 0-2, or -1 to compare all three levels
+ * @param options.functionName Time this function (returned by the chunk or global) instead of the whole chunk
+ */
+export async function benchmarkCode(options: {
+  iterations?: number;
+  warmup?: number;
+  optimizationLevel?: number;
+  functionName?: string;
+} = {}): Promise<void> {
+  const myRunId = ++currentRunId;
+  
+  setRunning(true);
+  clearOutput();
+  setExecutionTime(null);
+  
+  if (execution.worker && execution.pendingRequests.size > 0) {
+    await interruptExecution(CANCELLED_ERROR);
+    if (currentRunId !== myRunId) return;
+  }
+  
+  try {
+    const code = getActiveFileContent();
+    const iterations = options.iterations ?? BENCHMARK_ITERATIONS;
+    const warmup = options.warmup ?? BENCHMARK_WARMUP;
+    const target = options.functionName ? `${options.functionName} in ${get(activeFile)}` : get(activeFile);
+    
+    appendOutput({ type: 'log', text: `Benchmarking ${target}: ${iterations} iterations after ${warmup} warmup runs...` });
+    
+    await sendExecutionRequest('registerModules', { modules: getAllFiles() });
+    if (currentRunId !== myRunId) return;
+    
+    const { result } = await sendInterruptibleRequest('benchmark', {
+      code,
+      iterations,
+      warmup,
+      optimizationLevel: options.optimizationLevel ?? -1,
+      functionName: options.functionName ?? '',
+    });
+    
+    // A user stop is reported by stopExecution
+    if (currentRunId !== myRunId || (result.interrupted && stopRequested)) return;
+    
+    for (const level of result.levels) {
+      appendOutput(level.success
+        ? { type: 'log', text: formatBenchmarkLevel(level) }
+        : { type: 'error', text: `O${level.optimizationLevel}: ${level.error}` });
+    }
+    if (result.comparison) {
+      const speedups = result.comparison.slice(1).map((c) => `O${c.optimizationLevel} ${c.speedup.toFixed(2)}x`);
+      appendOutput({ type: 'log', text: `Median speedup over O${result.comparison[0].optimizationLevel}: ${speedups.join(', ')}` });
+    }
+  } catch (error) {
+    if (currentRunId === myRunId && error instanceof Error && 
+        error.message !== STOPPED_ERROR && error.message !== CANCELLED_ERROR) {
+      appendOutput({ type: 'error', text: `Error: ${error.message}` });
+    }
+  } finally {
+    if (currentRunId === myRunId) {
+      setRunning(false);
+    }
+  }
+}
+
+/**
+ * Rebuild the cached execution state in the execution worker, if it is running.
+ * Done automatically before the run following one that hit the memory cap.
+ */
+export async function resetExecution(): Promise<void> {
+  if (!execution.ready) return;
+  
+  try {
+    await sendToWorker(execution, 'reset', {});
+  } catch (error) {
+    console.error('[Luau] Failed to reset execution state:', error);
+  }
+}
+
 /**
  * Run type checking on the active file and display diagnostics.
  * Uses the analysis worker so it works even during execution.
@@ -517,17 +1207,21 @@ export async function checkCode(): Promise<void> {
   setExecutionTime(null);
 
   try {
-    const code = getActiveFileContent();
     const fileName = get(activeFile);
     
     appendOutput({ type: 'log', text: `Type checking ${fileName}...` });
     
-    const { diagnostics, elapsed } = await getDiagnostics(code);
+    const { diagnostics, elapsed, cancelled } = await getDiagnostics(fileName, { latestWins: false });
     
     if (currentRunId !== myRunId) return;
     
     setExecutionTime(elapsed);
     
+    if (cancelled) {
+      appendOutput({ type: 'warn', text: 'Type check cancelled: the file changed while it was running' });
+      return;
+    }
+    
     if (diagnostics.length === 0) {
       appendOutput({ type: 'log', text: '✓ No type errors found' });
     } else {
@@ -564,6 +1258,7 @@ export async function checkCode(): Promise<void> {
 
 /**
  * Get bytecode dump for code using the analysis worker.
+ * The worker keeps recent compiles and rendered formats, so switching formats is a lookup.
  */
 export async function getBytecode(
   code: string,
@@ -571,14 +1266,79 @@ export async function getBytecode(
   debugLevel: number = 2,
   outputFormat: number = 0,
   showRemarks: boolean = false
+): Promise<{ success: boolean; bytecode: string; error?: string }> {
+  const format = DUMP_FORMATS[outputFormat] ?? 'vm';
+  const result = await getBytecodeDumps(code, optimizationLevel, debugLevel, [format], showRemarks);
+  return { success: result.success, bytecode: result.formats?.[format] ?? '', error: result.error };
+}
+
+/**
+ * Get several dump formats from one compile using the analysis worker.
+ * With `stats`, also returns codegen lowering stats and opcode histograms per function
+ * for each requested codegen format.
+ */
+export async function getBytecodeDumps(
+  code: string,
+  optimizationLevel: number,
+  debugLevel: number,
+  formats: DumpFormatName[],
+  showRemarks: boolean = false,
+  stats: boolean = false
+): Promise<DumpResult> {
+  try {
+    const response = await sendAnalysisRequest('dumpAll', {
+      code,
+      optimizationLevel,
+      debugLevel,
+      formats,
+      showRemarks,
+      stats,
+    });
+    return response.result;
+  } catch (error) {
+    return {
+      success: false,
+      error: error instanceof Error ? error.message : String(error),
+    };
+  }
+}
+
+/**
+ * List the functions of a chunk (ids, line ranges) using the analysis worker.
+ */
+export async function getBytecodeFunctions(
+  code: string,
+  optimizationLevel: number,
+  debugLevel: number,
+  showRemarks: boolean = false
+): Promise<DumpFunctionsResult> {
+  try {
+    const response = await sendAnalysisRequest('dumpFunctions', { code, optimizationLevel, debugLevel, showRemarks });
+    return response.result;
+  } catch (error) {
+    return { success: false, error: error instanceof Error ? error.message : String(error) };
+  }
+}
+
+/**
+ * Dump a single function; IR and assembly are generated for that function only.
+ */
+export async function getFunctionBytecode(
+  code: string,
+  optimizationLevel: number,
+  debugLevel: number,
+  outputFormat: number,
+  functionId: number,
+  showRemarks: boolean = false
 ): Promise<{ success: boolean; bytecode: string; error?: string }> {
   try {
-    const response = await sendAnalysisRequest('getBytecode', { 
-      code, 
-      optimizationLevel, 
-      debugLevel, 
-      outputFormat, 
-      showRemarks 
+    const response = await sendAnalysisRequest('dumpFunction', {
+      code,
+      optimizationLevel,
+      debugLevel,
+      outputFormat,
+      functionId,
+      showRemarks,
     });
     return response.result;
   } catch (error) {
@@ -591,4 +1351,4 @@ export async function getBytecode(
 }
 
 // Export types
-export type { LuauDiagnostic, LuauCompletion, ExecuteResult };
+export type { LuauDiagnostic, LuauCompletion, CompletionDetails, ExecuteResult, ExecutionProfile, ExecutionCoverage, ExecutionMemoryStats, DocumentEdit, AnalysisStats, MemoryStats, SignatureResult, DumpResult, DumpFormatName, DumpFunction, LoweringStats, TraceEvent, TraceResult, BenchmarkResult, BenchmarkLevelResult };
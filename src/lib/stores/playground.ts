@@ -1,6 +1,7 @@
 import { writable, get } from 'svelte/store';
 import { parseStateFromHash } from '$lib/utils/decode';
 import type { OutputLine } from '$lib/utils/output';
+import type { ExecutionProfile } from '$lib/luau/types';
 
 // Re-export for backwards compatibility
 export type { OutputLine };
@@ -57,11 +58,17 @@ export const output = writable<OutputLine[]>([]);
 export const isRunning = writable<boolean>(false);
 export const executionTime = writable<number | null>(null);
 export const cursorLine = writable<number>(1);
+// Profile of the last profiled run and the file that was run as "main"
+export const executionProfile = writable<{ file: string; profile: ExecutionProfile } | null>(null);
 
 export function setExecutionTime(ms: number | null) {
   executionTime.set(ms);
 }
 
+export function setExecutionProfile(file: string, profile: ExecutionProfile | null) {
+  executionProfile.set(profile ? { file, profile } : null);
+}
+
 // Actions
 export function addFile(name: string, content: string = '') {
   files.update((f) => ({ ...f, [name]: content }));
@@ -112,6 +119,11 @@ export function appendOutput(line: OutputLine) {
   output.update((o) => [...o, line]);
 }
 
+export function appendOutputLines(lines: OutputLine[]) {
+  if (lines.length === 0) return;
+  output.update((o) => [...o, ...lines]);
+}
+
 export function clearOutput() {
   output.set([]);
 }
@@ -7,14 +7,20 @@
 /** Special float values that can't be represented as JSON numbers */
 export type SpecialFloat = 'inf' | '-inf' | 'nan';
 
+/** Marks a table whose entries past `offset` were cut off by a serialization budget */
+export interface LuauTruncation {
+  handle: number;
+  offset: number;
+}
+
 export type LuauValue = 
   | { type: 'nil' }
   | { type: 'boolean'; value: boolean }
   | { type: 'number'; value: number | SpecialFloat }
   | { type: 'string'; value: string }
-  | { type: 'table'; value: Record<string, LuauValue> | LuauValue[]; isArray: boolean }
+  | { type: 'table'; value: Record<string, LuauValue> | LuauValue[]; isArray: boolean; truncated?: LuauTruncation; tostring?: string }
   | { type: 'function' }
-  | { type: 'userdata' }
+  | { type: 'userdata'; tostring?: string }
   | { type: 'thread' }
   | { type: 'circular' }
   | { type: 'vector'; value: (number | SpecialFloat)[] }
@@ -26,6 +32,43 @@ export interface OutputLine {
   values?: LuauValue[];
 }
 
+/**
+ * Plain text form of a printed value, as Luau's tostring would produce it.
+ * Reference types without __tostring have no address in the records, so only the type is shown.
+ */
+export function luauValueToText(value: LuauValue): string {
+  switch (value.type) {
+    case 'nil':
+      return 'nil';
+    case 'boolean':
+    case 'number':
+    case 'string':
+      return String(value.value);
+    case 'table':
+    case 'userdata':
+      return value.tostring ?? value.type;
+    case 'vector':
+      return value.value.join(', ');
+    case 'circular':
+      return 'table';
+    default:
+      return value.type;
+  }
+}
+
+/**
+ * Output line for a print call; the plain text is rendered from the values only when read.
+ */
+export function printLine(values: LuauValue[]): OutputLine {
+  return {
+    type: 'log',
+    values,
+    get text() {
+      return values.map(luauValueToText).join('\t');
+    },
+  };
+}
+
 /**
  * Format execution time for display.
  */
@@ -11,6 +11,13 @@ import { compileGrammarPlugin } from './vite/compile-grammar';
 
 const __dirname = path.dirname(fileURLToPath(import.meta.url));
 
+// Shared memory with the workers needs a cross-origin isolated page. Deployments that
+// can't send these headers get them from public/coi-serviceworker.js instead.
+const crossOriginIsolationHeaders = {
+  'Cross-Origin-Opener-Policy': 'same-origin',
+  'Cross-Origin-Embedder-Policy': 'require-corp',
+};
+
 // https://vite.dev/config/
 export default defineConfig({
   plugins: [compileGrammarPlugin(), svelte(), tailwindcss(), preloadDynamicChunks(), prerenderPlugin(), inlineCss()],
@@ -22,4 +29,10 @@ export default defineConfig({
   build: {
     sourcemap: true,
   },
+  server: {
+    headers: crossOriginIsolationHeaders,
+  },
+  preview: {
+    headers: crossOriginIsolationHeaders,
+  },
 });
@@ -0,0 +1,429 @@
+/**
+ * Native headless benchmark for the playground exports.
+ *
+ * Links playground.cpp natively (EXPORT is a plain extern "C" outside Emscripten) and
+ * drives luau_execute, luau_get_diagnostics, luau_autocomplete, luau_hover and
+ * luau_dump_bytecode over the scripts in bench/corpus the way the workers do, with
+ * binary results. run-wasm.mjs runs the same schedule against the wasm build and writes
+ * the same report, so the two can be compared (compare.mjs).
+ *
+ * Afterwards each script with a `.expected` file next to it is checked: its type error
+ * count and its execution output must match, or the run exits with 1.
+ *
+ * Usage: luau_playground_bench [--corpus DIR] [--iterations N] [--typing-lines N] [--json FILE]
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+extern "C" {
+const char* luau_execute(const char* code, int timeLimitMs, int safepointLimit);
+void luau_set_source(const char* name, const char* source);
+int luau_apply_edit(const char* name, int startLine, int startCol, int endLine, int endCol, const char* text);
+const char* luau_get_diagnostics(const char* name, int version);
+const char* luau_autocomplete(const char* name, int version, int line, int col, const char* prefix, int limit);
+const char* luau_hover(const char* name, int version, int line, int col);
+const char* luau_dump_bytecode(const char* code, int optimizationLevel, int debugLevel, int outputFormat, bool showRemarks);
+void luau_set_result_encoding(int encoding);
+double luau_init_analysis();
+}
+
+#ifndef LUAU_PLAYGROUND_BENCH_CORPUS
+#define LUAU_PLAYGROUND_BENCH_CORPUS "bench/corpus"
+#endif
+
+// Time limit per execution; the corpus scripts finish well within it
+static const int kExecuteTimeLimitMs = 10000;
+
+// Dump formats, as in luau_dump_bytecode's outputFormat
+static const int kDumpFormats = 4;
+
+// Completion page size, as AUTOCOMPLETE_LIMIT in the editor
+static const int kAutocompleteLimit = 50;
+
+struct Options {
+    std::string corpus = LUAU_PLAYGROUND_BENCH_CORPUS;
+    int iterations = 20;
+    int typingLines = 8;
+    std::string jsonPath;
+};
+
+struct Script {
+    std::string name;       // file name, also the module and document name
+    std::string source;
+    
+    // From <name without .luau>.expected: "errors N", then the exact output lines
+    bool hasExpected = false;
+    int expectedErrors = 0;
+    std::string expectedOutput;
+};
+
+// Latency samples (ms) per export, overall and per script
+struct Samples {
+    std::map<std::string, std::vector<double>> total;
+    std::map<std::string, std::map<std::string, std::vector<double>>> perScript;
+
+    void add(const std::string& script, const char* call, double ms) {
+        total[call].push_back(ms);
+        perScript[script][call].push_back(ms);
+    }
+};
+
+static double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Time one call into the module and record it
+template<typename F>
+static void timed(Samples& samples, const std::string& script, const char* call, F&& f) {
+    double start = nowMs();
+    f();
+    samples.add(script, call, nowMs() - start);
+}
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--corpus" && hasValue) {
+            options.corpus = argv[++i];
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--typing-lines" && hasValue) {
+            options.typingLines = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--corpus DIR] [--iterations N] [--typing-lines N] [--json FILE]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+static void loadExpected(const std::filesystem::path& path, Script& script) {
+    if (!std::filesystem::exists(path)) return;
+    
+    std::string text = readFile(path);
+    size_t lineEnd = text.find('\n');
+    std::string header = text.substr(0, lineEnd);
+    if (sscanf(header.c_str(), "errors %d", &script.expectedErrors) != 1) {
+        fprintf(stderr, "%s: first line must be \"errors N\"\n", path.string().c_str());
+        return;
+    }
+    
+    // Output lines are joined by newlines, without a trailing one
+    script.expectedOutput = lineEnd == std::string::npos ? "" : text.substr(lineEnd + 1);
+    if (!script.expectedOutput.empty() && script.expectedOutput.back() == '\n') script.expectedOutput.pop_back();
+    script.hasExpected = true;
+}
+
+// .luau files of the corpus, sorted by name so both runners visit them in the same order
+static std::vector<Script> loadCorpus(const std::string& directory) {
+    std::vector<Script> scripts;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() != ".luau") continue;
+
+        Script script;
+        script.name = entry.path().filename().string();
+        script.source = readFile(entry.path());
+        loadExpected(std::filesystem::path(entry.path()).replace_extension(".expected"), script);
+        scripts.push_back(std::move(script));
+    }
+    std::sort(scripts.begin(), scripts.end(), [](const Script& a, const Script& b) { return a.name < b.name; });
+    return scripts;
+}
+
+// Documents are also the modules require loads, as "./vector" or "vector.luau"
+static void registerCorpus(const std::vector<Script>& scripts) {
+    for (const Script& script : scripts) {
+        luau_set_source(script.name.c_str(), script.source.c_str());
+    }
+}
+
+// Repeated runs of the unchanged script, as when pressing Run again
+static void benchExecute(Samples& samples, const Script& script, int iterations) {
+    for (int i = 0; i < iterations; i++) {
+        timed(samples, script.name, "luau_execute", [&] {
+            luau_execute(script.source.c_str(), kExecuteTimeLimitMs, 0);
+        });
+    }
+}
+
+// Each iteration dumps an edited source (a trailing comment), so the dump cache never hits
+static void benchDump(Samples& samples, const Script& script, int iterations) {
+    for (int i = 0; i < iterations; i++) {
+        std::string source = script.source + "\n-- edit " + std::to_string(i) + "\n";
+        timed(samples, script.name, "luau_dump_bytecode", [&] {
+            luau_dump_bytecode(source.c_str(), 1, 1, i % kDumpFormats, false);
+        });
+    }
+}
+
+/**
+ * Replay typing the script's last typingLines lines one character at a time: each
+ * keystroke applies an edit, then requests diagnostics, completions at the cursor and
+ * hover on the character before it. The document is restored afterwards.
+ */
+static void benchTyping(Samples& samples, const Script& script, int typingLines) {
+    const std::string& source = script.source;
+
+    std::vector<size_t> lineStarts = {0};
+    for (size_t i = 0; i < source.size(); i++) {
+        if (source[i] == '\n') lineStarts.push_back(i + 1);
+    }
+
+    int lineCount = static_cast<int>(lineStarts.size());
+    int line = std::max(0, lineCount - typingLines);
+    size_t typedFrom = lineStarts[line];
+
+    std::string prefix = source.substr(0, typedFrom);
+    luau_set_source(script.name.c_str(), prefix.c_str());
+    luau_get_diagnostics(script.name.c_str(), -1);
+
+    const char* name = script.name.c_str();
+    int col = 0;
+    std::string word;   // identifier before the cursor, the completion prefix
+    for (size_t i = typedFrom; i < source.size(); i++) {
+        char text[2] = {source[i], 0};
+        int version = 0;
+        timed(samples, script.name, "luau_apply_edit", [&] {
+            version = luau_apply_edit(name, line, col, line, col, text);
+        });
+
+        if (source[i] == '\n') {
+            line++;
+            col = 0;
+        } else {
+            col++;
+        }
+        
+        char c = source[i];
+        if (isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            word += c;
+        } else {
+            word.clear();
+        }
+
+        timed(samples, script.name, "luau_get_diagnostics", [&] {
+            luau_get_diagnostics(name, version);
+        });
+        timed(samples, script.name, "luau_autocomplete", [&] {
+            luau_autocomplete(name, version, line, col, word.c_str(), kAutocompleteLimit);
+        });
+        timed(samples, script.name, "luau_hover", [&] {
+            luau_hover(name, version, line, std::max(0, col - 1));
+        });
+    }
+
+    luau_set_source(name, source.c_str());
+}
+
+// JSON string as luau_execute writes it (json::appendString)
+static std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 32) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+static size_t countOccurrences(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size())) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Check each script that has a .expected file, with JSON results so they can be read
+ * here. Runs after the timed schedule, which restores every document, so the cold
+ * diagnostics above stay cold. Returns the number of failed checks.
+ */
+static int checkExpected(const std::vector<Script>& scripts) {
+    luau_set_result_encoding(0);
+    
+    int failures = 0;
+    for (const Script& script : scripts) {
+        if (!script.hasExpected) continue;
+        
+        std::string diagnostics = luau_get_diagnostics(script.name.c_str(), -1);
+        int errors = static_cast<int>(countOccurrences(diagnostics, "\"severity\":"));
+        if (errors != script.expectedErrors) {
+            fprintf(stderr, "%s: %d type errors, expected %d\n%s\n", script.name.c_str(), errors, script.expectedErrors, diagnostics.c_str());
+            failures++;
+        }
+        
+        std::string result = luau_execute(script.source.c_str(), kExecuteTimeLimitMs, 0);
+        std::string expected = "{\"success\":true,\"output\":" + jsonString(script.expectedOutput) + ",";
+        if (result.compare(0, expected.size(), expected) != 0) {
+            fprintf(stderr, "%s: unexpected execution result\n  expected %s...\n  got      %.*s\n", script.name.c_str(), expected.c_str(),
+                static_cast<int>(std::min<size_t>(result.size(), 2 * expected.size())), result.c_str());
+            failures++;
+        }
+    }
+    
+    luau_set_result_encoding(1);
+    return failures;
+}
+
+// Peak resident set size of the process, 0 where unavailable
+static size_t peakMemoryBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);            // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;     // kilobytes
+#endif
+#else
+    return 0;
+#endif
+}
+
+// Nearest-rank percentile of sorted samples, as in luau_benchmark
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+struct Distribution {
+    size_t count = 0;
+    double minMs = 0.0;
+    double medianMs = 0.0;
+    double p95Ms = 0.0;
+    double maxMs = 0.0;
+    double meanMs = 0.0;
+};
+
+static Distribution summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+
+    Distribution d;
+    d.count = samples.size();
+    d.minMs = samples.front();
+    d.medianMs = percentile(samples, 0.5);
+    d.p95Ms = percentile(samples, 0.95);
+    d.maxMs = samples.back();
+    d.meanMs = sum / samples.size();
+    return d;
+}
+
+static std::string callsJson(const std::map<std::string, std::vector<double>>& calls) {
+    std::string out = "{";
+    for (const auto& [call, samples] : calls) {
+        Distribution d = summarize(samples);
+        char buf[256];
+        snprintf(buf, sizeof(buf),
+            "%s\"%s\":{\"count\":%zu,\"minMs\":%.4f,\"medianMs\":%.4f,\"p95Ms\":%.4f,\"maxMs\":%.4f,\"meanMs\":%.4f}",
+            out.size() > 1 ? "," : "", call.c_str(), d.count, d.minMs, d.medianMs, d.p95Ms, d.maxMs, d.meanMs);
+        out += buf;
+    }
+    return out + "}";
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    std::vector<Script> scripts = loadCorpus(options.corpus);
+    if (scripts.empty()) {
+        fprintf(stderr, "No .luau scripts in %s\n", options.corpus.c_str());
+        return 1;
+    }
+
+    // The workers decode binary results; JSON serialization would skew the numbers
+    luau_set_result_encoding(1);
+    double initMs = luau_init_analysis();
+    registerCorpus(scripts);
+
+    Samples samples;
+    for (const Script& script : scripts) {
+        timed(samples, script.name, "luau_get_diagnostics (cold)", [&] {
+            luau_get_diagnostics(script.name.c_str(), -1);
+        });
+    }
+    for (const Script& script : scripts) {
+        benchExecute(samples, script, options.iterations);
+        benchDump(samples, script, options.iterations);
+        benchTyping(samples, script, options.typingLines);
+    }
+    
+    int failures = checkExpected(scripts);
+
+    std::string report = "{\"runtime\":\"native\"";
+    report += ",\"iterations\":" + std::to_string(options.iterations);
+    report += ",\"typingLines\":" + std::to_string(options.typingLines);
+    report += ",\"initAnalysisMs\":" + std::to_string(initMs);
+    report += ",\"peakMemoryBytes\":" + std::to_string(peakMemoryBytes());
+    report += ",\"checkFailures\":" + std::to_string(failures);
+    report += ",\"calls\":" + callsJson(samples.total);
+    report += ",\"scripts\":{";
+    bool first = true;
+    for (const auto& [script, calls] : samples.perScript) {
+        if (!first) report += ",";
+        first = false;
+        report += "\"" + script + "\":" + callsJson(calls);
+    }
+    report += "}}";
+
+    printf("%-30s %8s %10s %10s %10s %10s\n", "call", "count", "median ms", "p95 ms", "max ms", "mean ms");
+    for (const auto& [call, callSamples] : samples.total) {
+        Distribution d = summarize(callSamples);
+        printf("%-30s %8zu %10.3f %10.3f %10.3f %10.3f\n", call.c_str(), d.count, d.medianMs, d.p95Ms, d.maxMs, d.meanMs);
+    }
+    printf("peak memory: %.1f MB\n", peakMemoryBytes() / (1024.0 * 1024.0));
+    printf("expected results: %s\n", failures == 0 ? "ok" : (std::to_string(failures) + " failed").c_str());
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream out(options.jsonPath, std::ios::binary);
+        out << report << "\n";
+        if (!out) {
+            fprintf(stderr, "Could not write %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
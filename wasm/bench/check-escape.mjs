@@ -0,0 +1,170 @@
+// Checks that the SIMD and scalar builds escape printed strings identically.
+//
+// json::plainPrefix scans 16 bytes at a time in the SIMD build and one byte at a time
+// otherwise. This prints strings that put every escaped byte (0x00-0x1f, '"', '\') at
+// every offset of lengths 0..47, so both vector loads and scalar tails are covered next
+// to bytes that are left alone (space, 0x7f, 0x80-0xff). Each module's JSON result must
+// match a reference escaper byte for byte, and the results of all modules must be equal.
+// It then times a print-heavy run per module for a rough escaping throughput comparison.
+//
+// Both modules must be built for node first:
+//   LUAU_WASM_VARIANTS="node node-simd" ./build.sh
+//
+// Usage: node bench/check-escape.mjs [--module FILE]... [--iterations N]
+
+import { existsSync } from 'node:fs';
+import { dirname, join, resolve } from 'node:path';
+import { fileURLToPath, pathToFileURL } from 'node:url';
+import { performance } from 'node:perf_hooks';
+
+const HERE = dirname(fileURLToPath(import.meta.url));
+
+// Time limit per execution; neither script comes close
+const EXECUTE_TIME_LIMIT_MS = 10000;
+
+// Longest checked string: three 16-byte vectors and a full scalar tail
+const MAX_LENGTH = 47;
+
+const USAGE = 'Usage: node bench/check-escape.mjs [--module FILE]... [--iterations N]';
+
+const ESCAPED = [...Array(32).keys(), 0x22, 0x5c];
+const PLAIN = [0x61, 0x20, 0x7f, 0x80, 0xc3, 0xff, 0x21, 0x7e];
+
+function parseOptions(argv) {
+  const options = { modules: [], iterations: 20 };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = argv[i + 1];
+    if (value === undefined) throw new Error(USAGE);
+    i++;
+    if (arg === '--module') options.modules.push(resolve(value));
+    else if (arg === '--iterations') options.iterations = Math.max(1, parseInt(value, 10) || 1);
+    else throw new Error(USAGE);
+  }
+  if (options.modules.length === 0) {
+    options.modules = [join(HERE, '..', 'build-node', 'luau.js'), join(HERE, '..', 'build-node-simd', 'luau-simd.js')];
+  }
+  return options;
+}
+
+// Strings to print, as byte arrays
+function buildCases() {
+  const cases = [];
+  const filler = (length, seed) => Array.from({ length }, (_, i) => PLAIN[(i + seed) % PLAIN.length]);
+
+  for (let length = 0; length <= MAX_LENGTH; length++) {
+    // Nothing to escape
+    cases.push(filler(length, length));
+
+    // One escaped byte at each offset, cycling through all of them
+    for (let offset = 0; offset < length; offset++) {
+      const bytes = filler(length, offset);
+      bytes[offset] = ESCAPED[(length + offset) % ESCAPED.length];
+      cases.push(bytes);
+    }
+
+    // Only escaped bytes
+    cases.push(Array.from({ length }, (_, i) => ESCAPED[(i + length) % ESCAPED.length]));
+  }
+
+  // Every escaped byte in the first vector, on a vector boundary and in the tail
+  for (const byte of ESCAPED) {
+    for (const offset of [0, 7, 15, 16, 31, 32]) {
+      const bytes = filler(33, byte);
+      bytes[offset] = byte;
+      cases.push(bytes);
+    }
+  }
+  return cases;
+}
+
+// Luau source printing each case, every byte as a \x escape
+function casesSource(cases) {
+  const hex = (byte) => `\\x${byte.toString(16).padStart(2, '0')}`;
+  return cases.map((bytes) => `print("${bytes.map(hex).join('')}")`).join('\n') + '\n';
+}
+
+// Same output as json::appendEscaped
+function referenceEscape(bytes) {
+  const out = [];
+  for (const byte of bytes) {
+    if (byte === 0x22) out.push(0x5c, 0x22);
+    else if (byte === 0x5c) out.push(0x5c, 0x5c);
+    else if (byte === 0x0a) out.push(0x5c, 0x6e);
+    else if (byte === 0x0d) out.push(0x5c, 0x72);
+    else if (byte === 0x09) out.push(0x5c, 0x74);
+    else if (byte < 0x20) out.push(...Buffer.from(`\\u${byte.toString(16).padStart(4, '0')}`));
+    else out.push(byte);
+  }
+  return out;
+}
+
+// The "prints" array luau_execute returns for the cases
+function expectedPrints(cases) {
+  const parts = cases.map((bytes) => Buffer.concat([
+    Buffer.from('[{"type":"string","value":"'),
+    Buffer.from(referenceEscape(bytes)),
+    Buffer.from('"}]'),
+  ]));
+  return Buffer.concat([Buffer.from('"prints":['), ...parts.flatMap((part, i) => (i > 0 ? [Buffer.from(','), part] : [part])), Buffer.from(']')]);
+}
+
+async function loadModule(file) {
+  if (!existsSync(file)) throw new Error(`${file} not found; build it with LUAU_WASM_VARIANTS="node node-simd" ./build.sh`);
+  const { default: createLuauModule } = await import(pathToFileURL(file).href);
+  const module = await createLuauModule();
+  module.ccall('luau_set_result_encoding', null, ['number'], [0]);
+  return module;
+}
+
+// JSON result bytes, read raw: strings with bytes 0x80-0xff are not valid UTF-8
+function execute(module, source) {
+  const ptr = module.ccall('luau_execute', 'number', ['string', 'number', 'number'], [source, EXECUTE_TIME_LIMIT_MS, 0]);
+  const end = module.HEAPU8.indexOf(0, ptr);
+  return Buffer.from(module.HEAPU8.subarray(ptr, end));
+}
+
+async function main() {
+  const options = parseOptions(process.argv.slice(2));
+  const cases = buildCases();
+  const source = casesSource(cases);
+  const expected = expectedPrints(cases);
+
+  // Long strings with an escaped byte every 40 bytes, so most of the time is in plain runs
+  const longLine = `string.rep("${'a'.repeat(39)}\\t", 1000)`;
+  const timingSource = `local s = ${longLine}\nfor i = 1, 200 do print(s) end\n`;
+
+  let failures = 0;
+  let reference = null;
+  for (const file of options.modules) {
+    const module = await loadModule(file);
+    const result = execute(module, source);
+
+    if (!result.includes(expected)) {
+      console.error(`${file}: prints differ from the reference escaper`);
+      failures++;
+    }
+    if (reference && !result.equals(reference.result)) {
+      console.error(`${file}: result differs from ${reference.file}`);
+      failures++;
+    }
+    reference ??= { file, result };
+
+    const times = [];
+    for (let i = 0; i < options.iterations; i++) {
+      const start = performance.now();
+      execute(module, timingSource);
+      times.push(performance.now() - start);
+    }
+    times.sort((a, b) => a - b);
+    console.log(`${file}: ${cases.length} strings checked, print-heavy run median ${times[Math.floor(times.length / 2)].toFixed(3)} ms`);
+  }
+
+  if (failures > 0) process.exit(1);
+  console.log('Escaping matches');
+}
+
+main().catch((error) => {
+  console.error(error.message ?? error);
+  process.exit(1);
+});
@@ -0,0 +1,49 @@
+// Compares two benchmark reports (bench.cpp --json or run-wasm.mjs --json) call by call.
+//
+// Usage: node bench/compare.mjs BASE.json CURRENT.json [--threshold RATIO]
+//
+// Exits with 1 when any call's median in CURRENT is slower than BASE by more than the
+// threshold (default 1.10), or when CURRENT failed its expected results, so it can gate a
+// change against a saved baseline report.
+
+import { readFileSync } from 'node:fs';
+
+const USAGE = 'Usage: node bench/compare.mjs BASE.json CURRENT.json [--threshold RATIO]';
+
+const args = process.argv.slice(2);
+let threshold = 1.1;
+const files = [];
+for (let i = 0; i < args.length; i++) {
+  if (args[i] === '--threshold' && i + 1 < args.length) threshold = parseFloat(args[++i]);
+  else files.push(args[i]);
+}
+if (files.length !== 2 || !(threshold > 0)) {
+  console.error(USAGE);
+  process.exit(1);
+}
+
+const [base, current] = files.map((file) => JSON.parse(readFileSync(file, 'utf8')));
+
+console.log(`${base.runtime} -> ${current.runtime} (median ms, ratio > ${threshold.toFixed(2)} is a regression)`);
+console.log(`${'call'.padEnd(30)} ${'base'.padStart(10)} ${'current'.padStart(10)} ${'ratio'.padStart(8)}`);
+
+let regressions = 0;
+for (const [call, b] of Object.entries(base.calls)) {
+  const c = current.calls[call];
+  if (!c) continue;
+
+  const ratio = b.medianMs > 0 ? c.medianMs / b.medianMs : 1;
+  const regressed = ratio > threshold;
+  if (regressed) regressions++;
+
+  console.log(`${call.padEnd(30)} ${b.medianMs.toFixed(3).padStart(10)} ${c.medianMs.toFixed(3).padStart(10)} ${ratio.toFixed(2).padStart(8)}${regressed ? '  !' : ''}`);
+}
+
+const memoryRatio = base.peakMemoryBytes > 0 ? current.peakMemoryBytes / base.peakMemoryBytes : 1;
+console.log(`peak memory: ${(base.peakMemoryBytes / 1048576).toFixed(1)} MB -> ${(current.peakMemoryBytes / 1048576).toFixed(1)} MB (${memoryRatio.toFixed(2)})`);
+
+// A report whose results were wrong is no baseline to compare timings against
+const checkFailures = current.checkFailures ?? 0;
+if (checkFailures > 0) console.log(`${checkFailures} expected results failed in CURRENT`);
+
+process.exit(regressions > 0 || checkFailures > 0 ? 1 : 0);
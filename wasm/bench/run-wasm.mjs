@@ -0,0 +1,258 @@
+// Runs the bench.cpp schedule against the wasm module and writes the same report.
+//
+// The module must be built for node first:
+//   LUAU_WASM_VARIANTS=node ./build.sh
+//
+// Scripts with a .expected file are checked afterwards, as in bench.cpp (exit code 1 on
+// a mismatch).
+//
+// Usage: node bench/run-wasm.mjs [--module FILE] [--corpus DIR] [--iterations N] [--typing-lines N] [--json FILE]
+
+import { existsSync, readdirSync, readFileSync, writeFileSync } from 'node:fs';
+import { basename, dirname, extname, join, resolve } from 'node:path';
+import { fileURLToPath, pathToFileURL } from 'node:url';
+import { performance } from 'node:perf_hooks';
+
+const HERE = dirname(fileURLToPath(import.meta.url));
+
+// Time limit per execution; the corpus scripts finish well within it
+const EXECUTE_TIME_LIMIT_MS = 10000;
+
+// Dump formats, as in luau_dump_bytecode's outputFormat
+const DUMP_FORMATS = 4;
+
+// Completion page size, as AUTOCOMPLETE_LIMIT in the editor
+const AUTOCOMPLETE_LIMIT = 50;
+
+const USAGE = 'Usage: node bench/run-wasm.mjs [--module FILE] [--corpus DIR] [--iterations N] [--typing-lines N] [--json FILE]';
+
+function parseOptions(argv) {
+  const options = {
+    module: join(HERE, '..', 'build-node', 'luau.js'),
+    corpus: join(HERE, 'corpus'),
+    iterations: 20,
+    typingLines: 8,
+    json: '',
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const value = argv[i + 1];
+    if (value === undefined) throw new Error(USAGE);
+    i++;
+    if (arg === '--module') options.module = resolve(value);
+    else if (arg === '--corpus') options.corpus = resolve(value);
+    else if (arg === '--iterations') options.iterations = Math.max(1, parseInt(value, 10) || 1);
+    else if (arg === '--typing-lines') options.typingLines = Math.max(0, parseInt(value, 10) || 0);
+    else if (arg === '--json') options.json = resolve(value);
+    else throw new Error(USAGE);
+  }
+  return options;
+}
+
+// <name without .luau>.expected: "errors N", then the exact output lines
+function loadExpected(file) {
+  if (!existsSync(file)) return undefined;
+  const [header, ...lines] = readFileSync(file, 'utf8').replace(/\n$/, '').split('\n');
+  const match = /^errors (\d+)$/.exec(header);
+  if (!match) throw new Error(`${file}: first line must be "errors N"`);
+  return { errors: parseInt(match[1], 10), output: lines.join('\n') };
+}
+
+// .luau files of the corpus, sorted by name like bench.cpp
+function loadCorpus(directory) {
+  return readdirSync(directory)
+    .filter((file) => extname(file) === '.luau')
+    .sort()
+    .map((file) => ({
+      name: file,
+      source: readFileSync(join(directory, file), 'utf8'),
+      expected: loadExpected(join(directory, `${basename(file, '.luau')}.expected`)),
+    }));
+}
+
+// Type error counts and execution output against the .expected files, with JSON results
+// (see checkExpected in bench.cpp). Returns the number of failed checks.
+function checkExpected(module, scripts) {
+  module.ccall('luau_set_result_encoding', null, ['number'], [0]);
+  const callJson = (name, types, args) => JSON.parse(module.ccall(name, 'string', types, args));
+
+  let failures = 0;
+  for (const { name, source, expected } of scripts) {
+    if (!expected) continue;
+
+    const { diagnostics } = callJson('luau_get_diagnostics', ['string', 'number'], [name, -1]);
+    if (diagnostics.length !== expected.errors) {
+      console.error(`${name}: ${diagnostics.length} type errors, expected ${expected.errors}`);
+      for (const d of diagnostics) console.error(`  ${d.startLine + 1}:${d.startCol + 1} ${d.message}`);
+      failures++;
+    }
+
+    const result = callJson('luau_execute', ['string', 'number', 'number'], [source, EXECUTE_TIME_LIMIT_MS, 0]);
+    if (!result.success || result.output !== expected.output) {
+      console.error(`${name}: unexpected execution result`);
+      console.error(`  expected ${JSON.stringify(expected.output)}`);
+      console.error(`  got      ${JSON.stringify(result.output)}${result.error ? ` (${result.error})` : ''}`);
+      failures++;
+    }
+  }
+
+  module.ccall('luau_set_result_encoding', null, ['number'], [1]);
+  return failures;
+}
+
+class Samples {
+  total = new Map();
+  perScript = new Map();
+
+  add(script, call, ms) {
+    if (!this.total.has(call)) this.total.set(call, []);
+    this.total.get(call).push(ms);
+
+    if (!this.perScript.has(script)) this.perScript.set(script, new Map());
+    const calls = this.perScript.get(script);
+    if (!calls.has(call)) calls.set(call, []);
+    calls.get(call).push(ms);
+  }
+}
+
+function timed(samples, script, call, fn) {
+  const start = performance.now();
+  const result = fn();
+  samples.add(script, call, performance.now() - start);
+  return result;
+}
+
+// Nearest-rank percentile of sorted samples, as in luau_benchmark
+function percentile(sorted, p) {
+  const rank = Math.ceil(p * sorted.length);
+  return sorted[Math.min(Math.max(rank, 1), sorted.length) - 1];
+}
+
+function summarize(samples) {
+  const sorted = [...samples].sort((a, b) => a - b);
+  const sum = sorted.reduce((total, sample) => total + sample, 0);
+  return {
+    count: sorted.length,
+    minMs: sorted[0],
+    medianMs: percentile(sorted, 0.5),
+    p95Ms: percentile(sorted, 0.95),
+    maxMs: sorted[sorted.length - 1],
+    meanMs: sum / sorted.length,
+  };
+}
+
+function summarizeCalls(calls) {
+  const out = {};
+  for (const call of [...calls.keys()].sort()) out[call] = summarize(calls.get(call));
+  return out;
+}
+
+async function main() {
+  const options = parseOptions(process.argv.slice(2));
+  const scripts = loadCorpus(options.corpus);
+  if (scripts.length === 0) throw new Error(`No .luau scripts in ${options.corpus}`);
+
+  const { default: createLuauModule } = await import(pathToFileURL(options.module).href);
+  const module = await createLuauModule();
+
+  // Results are returned as pointers and left undecoded: the workers read binary results
+  // straight from HEAPU8, and decoding them here would only measure this script
+  const call = (name, args) =>
+    module.ccall(name, 'number', args.map((arg) => (typeof arg === 'string' ? 'string' : 'number')), args);
+
+  module.ccall('luau_set_result_encoding', null, ['number'], [1]);
+  const initMs = module.ccall('luau_init_analysis', 'number', [], []);
+
+  // Documents are also the modules require loads, as in bench.cpp
+  for (const script of scripts) {
+    call('luau_set_source', [script.name, script.source]);
+  }
+
+  const samples = new Samples();
+  for (const script of scripts) {
+    timed(samples, script.name, 'luau_get_diagnostics (cold)', () => call('luau_get_diagnostics', [script.name, -1]));
+  }
+
+  for (const script of scripts) {
+    for (let i = 0; i < options.iterations; i++) {
+      timed(samples, script.name, 'luau_execute', () =>
+        call('luau_execute', [script.source, EXECUTE_TIME_LIMIT_MS, 0]));
+    }
+
+    for (let i = 0; i < options.iterations; i++) {
+      const source = `${script.source}\n-- edit ${i}\n`;
+      timed(samples, script.name, 'luau_dump_bytecode', () =>
+        call('luau_dump_bytecode', [source, 1, 1, i % DUMP_FORMATS, 0]));
+    }
+
+    // Typing replay of the last lines, one character per keystroke (see benchTyping)
+    const { source, name } = script;
+    const lineStarts = [0];
+    for (let i = 0; i < source.length; i++) {
+      if (source[i] === '\n') lineStarts.push(i + 1);
+    }
+
+    let line = Math.max(0, lineStarts.length - options.typingLines);
+    let col = 0;
+    let word = ''; // identifier before the cursor, the completion prefix
+    const typedFrom = lineStarts[line];
+    call('luau_set_source', [name, source.slice(0, typedFrom)]);
+    call('luau_get_diagnostics', [name, -1]);
+
+    for (let i = typedFrom; i < source.length; i++) {
+      const version = timed(samples, name, 'luau_apply_edit', () =>
+        call('luau_apply_edit', [name, line, col, line, col, source[i]]));
+
+      if (source[i] === '\n') {
+        line++;
+        col = 0;
+      } else {
+        // Columns are bytes, as on the C++ side
+        col += Buffer.byteLength(source[i]);
+      }
+      word = /\w/.test(source[i]) ? word + source[i] : '';
+
+      timed(samples, name, 'luau_get_diagnostics', () => call('luau_get_diagnostics', [name, version]));
+      timed(samples, name, 'luau_autocomplete', () => call('luau_autocomplete', [name, version, line, col, word, AUTOCOMPLETE_LIMIT]));
+      timed(samples, name, 'luau_hover', () => call('luau_hover', [name, version, line, Math.max(0, col - 1)]));
+    }
+
+    call('luau_set_source', [name, source]);
+  }
+
+  // After the schedule, so the cold diagnostics above stay cold
+  const checkFailures = checkExpected(module, scripts);
+
+  const perScript = {};
+  for (const script of [...samples.perScript.keys()].sort()) {
+    perScript[script] = summarizeCalls(samples.perScript.get(script));
+  }
+
+  // Linear memory only grows, so its size is the peak
+  const report = {
+    runtime: 'wasm',
+    iterations: options.iterations,
+    typingLines: options.typingLines,
+    initAnalysisMs: initMs,
+    peakMemoryBytes: module.HEAPU8.length,
+    checkFailures,
+    calls: summarizeCalls(samples.total),
+    scripts: perScript,
+  };
+
+  const pad = (value, width) => String(value).padStart(width);
+  console.log(`${'call'.padEnd(30)} ${pad('count', 8)} ${pad('median ms', 10)} ${pad('p95 ms', 10)} ${pad('max ms', 10)} ${pad('mean ms', 10)}`);
+  for (const [name, d] of Object.entries(report.calls)) {
+    console.log(`${name.padEnd(30)} ${pad(d.count, 8)} ${pad(d.medianMs.toFixed(3), 10)} ${pad(d.p95Ms.toFixed(3), 10)} ${pad(d.maxMs.toFixed(3), 10)} ${pad(d.meanMs.toFixed(3), 10)}`);
+  }
+  console.log(`peak memory: ${(report.peakMemoryBytes / (1024 * 1024)).toFixed(1)} MB`);
+  console.log(`expected results: ${checkFailures === 0 ? 'ok' : `${checkFailures} failed`}`);
+
+  if (options.json) writeFileSync(options.json, JSON.stringify(report) + '\n');
+  if (checkFailures > 0) process.exit(1);
+}
+
+main().catch((error) => {
+  console.error(error.message ?? error);
+  process.exit(1);
+});
@@ -7,6 +7,10 @@
 #
 # Usage:
 #   ./build.sh [debug|release]
+#
+# LUAU_WASM_VARIANTS selects the variants to build (default: "baseline simd").
+# "node" builds the module for bench/run-wasm.mjs into build-node, "node-simd" its SIMD
+# build into build-node-simd (for bench/check-escape.mjs); neither is served.
 
 set -e
 
@@ -27,38 +31,73 @@ if [ ! -d "$LUAU_DIR" ] || [ ! -f "$LUAU_DIR/CMakeLists.txt" ]; then
     git clone --depth 1 https://github.com/Roblox/luau.git "$LUAU_DIR"
 fi
 
-# Create build directory
-BUILD_DIR="$SCRIPT_DIR/build"
-mkdir -p "$BUILD_DIR"
-cd "$BUILD_DIR"
-
-# Configure with CMake
-echo "Configuring with CMake (Build type: $BUILD_TYPE)..."
-emcmake cmake .. \
-    -DCMAKE_BUILD_TYPE="$BUILD_TYPE" \
-    -DLUAU_SOURCE_DIR="$LUAU_DIR"
-
-# Build
-echo "Building..."
-emmake make -j$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
+# Variants to build; the SIMD one is loaded by browsers that validate SIMD instructions
+VARIANTS="${LUAU_WASM_VARIANTS:-baseline simd}"
 
-# Copy WASM to public/wasm directory (served at runtime)
 OUTPUT_DIR="$SCRIPT_DIR/../public/wasm"
 mkdir -p "$OUTPUT_DIR"
 
-echo "Copying output files..."
-if [ -f luau.wasm ]; then
-    cp luau.wasm "$OUTPUT_DIR/"
-fi
+# Configure and build one variant in its own build directory
+build_variant() {
+    local build_dir="$1"
+    shift
+
+    mkdir -p "$build_dir"
+    cd "$build_dir"
+
+    echo "Configuring $(basename "$build_dir") with CMake (Build type: $BUILD_TYPE)..."
+    emcmake cmake "$SCRIPT_DIR" \
+        -DCMAKE_BUILD_TYPE="$BUILD_TYPE" \
+        -DLUAU_SOURCE_DIR="$LUAU_DIR" \
+        "$@"
 
-# Copy JS module to src for bundling (with Vite ignore comment to suppress URL warning)
-SRC_OUTPUT="$SCRIPT_DIR/../src/lib/luau/luau-module.js"
-echo "// @ts-nocheck" > "$SRC_OUTPUT"
-sed 's/(new URL("luau.wasm",import.meta.url))/(new URL(\/* @vite-ignore *\/ "luau.wasm",import.meta.url))/g' luau.js >> "$SRC_OUTPUT"
+    echo "Building..."
+    emmake make -j$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
+}
+
+for variant in $VARIANTS; do
+    case "$variant" in
+        baseline)
+            build_variant "$SCRIPT_DIR/build"
+
+            # Copy WASM to public/wasm directory (served at runtime)
+            echo "Copying output files..."
+            if [ -f luau.wasm ]; then
+                cp luau.wasm "$OUTPUT_DIR/"
+            fi
+            # The execution-only module's JS is served like the other variants'
+            cp luau-execution.wasm luau-execution.js "$OUTPUT_DIR/"
+
+            # Copy JS module to src for bundling (with Vite ignore comment to suppress URL warning)
+            SRC_OUTPUT="$SCRIPT_DIR/../src/lib/luau/luau-module.js"
+            echo "// @ts-nocheck" > "$SRC_OUTPUT"
+            sed 's/(new URL("luau.wasm",import.meta.url))/(new URL(\/* @vite-ignore *\/ "luau.wasm",import.meta.url))/g' luau.js >> "$SRC_OUTPUT"
+            ;;
+        simd)
+            build_variant "$SCRIPT_DIR/build-simd" -DLUAU_PLAYGROUND_SIMD=ON
+
+            # Served rather than bundled, so its JS module always matches its exports
+            echo "Copying output files..."
+            cp luau-simd.wasm luau-simd.js luau-execution-simd.wasm luau-execution-simd.js "$OUTPUT_DIR/"
+            ;;
+        node)
+            # Stays in build-node for the benchmark runner
+            build_variant "$SCRIPT_DIR/build-node" -DLUAU_PLAYGROUND_ENVIRONMENT=node
+            ;;
+        node-simd)
+            build_variant "$SCRIPT_DIR/build-node-simd" -DLUAU_PLAYGROUND_ENVIRONMENT=node -DLUAU_PLAYGROUND_SIMD=ON
+            ;;
+        *)
+            echo "Error: unknown variant '$variant'"
+            exit 1
+            ;;
+    esac
+done
 
 echo ""
 echo "Build complete!"
 echo "Output files:"
-[ -f "$OUTPUT_DIR/luau.wasm" ] && echo "  - $OUTPUT_DIR/luau.wasm"
-echo "  - $SRC_OUTPUT (bundled)"
-
+for file in luau.wasm luau-execution.wasm luau-simd.wasm luau-execution-simd.wasm; do
+    [ -f "$OUTPUT_DIR/$file" ] && echo "  - $OUTPUT_DIR/$file"
+done
+[ -f "$SCRIPT_DIR/../src/lib/luau/luau-module.js" ] && echo "  - $SCRIPT_DIR/../src/lib/luau/luau-module.js (bundled)"
@@ -0,0 +1,148 @@
+/**
+ * Per-function codegen output for the bytecode panel.
+ *
+ * CodeGen::getAssembly lowers every function of a chunk. To lower only one, the loaded
+ * protos' native flags are rewritten the way the compiler marks @native functions, so
+ * getAssembly's function gathering picks just the selected proto; the original flags are
+ * restored afterwards. This needs the VM's internal Proto layout, hence its own file.
+ */
+
+#include "codegen_functions.h"
+
+#include "Luau/Bytecode.h"
+
+#include "lua.h"
+#include "lapi.h"
+#include "ldebug.h"
+#include "lobject.h"
+#include "lstate.h"
+
+#include <algorithm>
+#include <climits>
+
+static Proto* chunkProto(lua_State* L)
+{
+    return clvalue(luaA_toobject(L, -1))->l.p;
+}
+
+// Every proto of the chunk, indexed by bytecode id (inlined functions share protos at -O2)
+static void gatherProtos(std::vector<Proto*>& protos, Proto* proto)
+{
+    if (protos.size() <= size_t(proto->bytecodeid))
+        protos.resize(proto->bytecodeid + 1);
+
+    if (protos[proto->bytecodeid])
+        return;
+
+    protos[proto->bytecodeid] = proto;
+
+    for (int i = 0; i < proto->sizep; i++)
+        gatherProtos(protos, proto->p[i]);
+}
+
+std::vector<CodegenFunction> listCodegenFunctions(lua_State* L)
+{
+    Proto* root = chunkProto(L);
+
+    std::vector<Proto*> protos;
+    gatherProtos(protos, root);
+
+    std::vector<CodegenFunction> functions;
+    int instructionOffset = 0;
+
+    for (Proto* p : protos)
+    {
+        if (!p)
+            continue;
+
+        CodegenFunction function;
+        function.id = p->bytecodeid;
+        function.name = p->debugname ? getstr(p->debugname) : "";
+        function.isMain = p == root;
+        function.instructionOffset = instructionOffset;
+        function.instructions = p->sizecode;
+
+        // Without line info (debug level 0) only linedefined is known
+        int lineStart = p->linedefined > 0 ? p->linedefined : INT_MAX;
+        int lineEnd = p->linedefined;
+        for (int pc = 0; pc < p->sizecode; pc++)
+        {
+            int line = luaG_getline(p, pc);
+            if (line <= 0)
+                continue;
+
+            lineStart = std::min(lineStart, line);
+            lineEnd = std::max(lineEnd, line);
+        }
+        function.lineStart = lineStart == INT_MAX ? 0 : lineStart;
+        function.lineEnd = lineEnd;
+
+        instructionOffset += p->sizecode;
+        functions.push_back(std::move(function));
+    }
+
+    return functions;
+}
+
+namespace
+{
+
+// Puts the protos' flags back when lowering finishes or throws
+struct ProtoFlagsRestore
+{
+    std::vector<std::pair<Proto*, uint8_t>> saved;
+
+    ~ProtoFlagsRestore()
+    {
+        for (auto& [proto, flags] : saved)
+            proto->flags = flags;
+    }
+};
+
+} // namespace
+
+std::string getFunctionAssembly(lua_State* L, int functionId, Luau::CodeGen::AssemblyOptions options, Luau::CodeGen::LoweringStats* stats)
+{
+    Proto* root = chunkProto(L);
+
+    std::vector<Proto*> protos;
+    gatherProtos(protos, root);
+
+    if (functionId < 0 || size_t(functionId) >= protos.size() || !protos[functionId])
+        return std::string();
+
+    Proto* selected = protos[functionId];
+
+    ProtoFlagsRestore restore;
+    for (Proto* p : protos)
+    {
+        if (!p)
+            continue;
+
+        restore.saved.emplace_back(p, p->flags);
+
+        if (selected == root)
+        {
+            // Without native functions every warm proto is gathered; mark the others cold
+            p->flags &= ~LPF_NATIVE_FUNCTION;
+
+            if (p == root)
+                p->flags &= ~LPF_NATIVE_COLD;
+            else
+                p->flags |= LPF_NATIVE_COLD;
+        }
+        else
+        {
+            // The root's flag says the chunk has native functions; then only those are gathered
+            if (p == root || p == selected)
+                p->flags |= LPF_NATIVE_FUNCTION;
+            else
+                p->flags &= ~LPF_NATIVE_FUNCTION;
+        }
+    }
+
+    if (selected == root)
+        options.compilationOptions.flags &= ~Luau::CodeGen::CodeGen_ColdFunctions;
+
+    return Luau::CodeGen::getAssembly(L, -1, options, stats);
+}
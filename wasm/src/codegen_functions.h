@@ -0,0 +1,29 @@
+/**
+ * Per-function views of a loaded chunk for the bytecode panel.
+ */
+
+#pragma once
+
+#include "Luau/CodeGen.h"
+
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+struct CodegenFunction
+{
+    int id = 0;                 // bytecode function id
+    std::string name;           // empty for anonymous functions and the main chunk
+    bool isMain = false;
+    int lineStart = 0;          // source lines spanned by the function's code (1-based)
+    int lineEnd = 0;
+    int instructionOffset = 0;  // of the function's code in the chunk's instruction stream (id order)
+    int instructions = 0;
+};
+
+// Functions of the chunk at the top of L's stack, in bytecode id order
+std::vector<CodegenFunction> listCodegenFunctions(lua_State* L);
+
+// IR/assembly for one function of the chunk at the top of L's stack; empty for unknown ids
+std::string getFunctionAssembly(lua_State* L, int functionId, Luau::CodeGen::AssemblyOptions options, Luau::CodeGen::LoweringStats* stats);
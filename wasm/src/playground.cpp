@@ -7,43 +7,76 @@
  */
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <algorithm>
+#include <utility>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 // Luau headers
 #include "Luau/Ast.h"
+#include "Luau/BytecodeBuilder.h"
+#include "Luau/Common.h"
+#include "Luau/Compiler.h"
+#include "Luau/Parser.h"
+
+// The execution-only module (luau_execution target) has no Analysis, Config or CodeGen;
+// it leaves out the bytecode dump and analysis sections at the end of this file
+#ifndef LUAU_PLAYGROUND_EXECUTION_ONLY
 #include "Luau/AstQuery.h"
 #include "Luau/Autocomplete.h"
 #include "Luau/BuiltinDefinitions.h"
-#include "Luau/BytecodeBuilder.h"
+#include "Luau/Cancellation.h"
 #include "Luau/CodeGen.h"
-#include "Luau/Common.h"
-#include "Luau/Compiler.h"
 #include "Luau/Config.h"
+#include "Luau/Error.h"
 #include "Luau/Frontend.h"
 #include "Luau/Linter.h"
 #include "Luau/Module.h"
 #include "Luau/ModuleResolver.h"
-#include "Luau/Parser.h"
 #include "Luau/Scope.h"
 #include "Luau/ToString.h"
+#include "Luau/Type.h"
+#include "Luau/TypeArena.h"
+#include "Luau/TypePack.h"
 #include "Luau/TypeInfer.h"
 
 // Feature flags for new solver
 LUAU_FASTFLAG(LuauSolverV2)
 LUAU_FASTFLAG(LuauUseWorkspacePropToChooseSolver)
 
+// Codegen heuristics limits (defined in codegen_stubs.cpp), reported with lowering stats
+LUAU_FASTINT(CodegenHeuristicsInstructionLimit)
+LUAU_FASTINT(CodegenHeuristicsBlockLimit)
+LUAU_FASTINT(CodegenHeuristicsBlockInstructionLimit)
+#endif
+
 // Luau VM headers
 #include "lua.h"
 #include "lualib.h"
 #include "luacode.h"
 
+#ifndef LUAU_PLAYGROUND_EXECUTION_ONLY
+#include "codegen_functions.h"
+#endif
+
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <emscripten/heap.h>
+#include <malloc.h>
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
 #define EXPORT extern "C" EMSCRIPTEN_KEEPALIVE
 #else
 #define EXPORT extern "C"
@@ -54,31 +87,77 @@ LUAU_FASTFLAG(LuauUseWorkspacePropToChooseSolver)
 // ============================================================================
 
 namespace json {
-    std::string escape(const std::string& s) {
-        std::string result;
-        result.reserve(s.size());
-        for (char c : s) {
+    // Length of the leading run of `data` that is copied to JSON unchanged
+    size_t plainPrefix(const char* data, size_t size) {
+        size_t i = 0;
+#ifdef __wasm_simd128__
+        // SIMD build: test 16 bytes at a time for a quote, a backslash or a control character
+        const v128_t quote = wasm_i8x16_splat('"');
+        const v128_t backslash = wasm_i8x16_splat('\\');
+        const v128_t space = wasm_i8x16_splat(32);
+        for (; i + 16 <= size; i += 16) {
+            v128_t chunk = wasm_v128_load(data + i);
+            v128_t special = wasm_v128_or(
+                wasm_v128_or(wasm_i8x16_eq(chunk, quote), wasm_i8x16_eq(chunk, backslash)),
+                wasm_u8x16_lt(chunk, space)
+            );
+            uint32_t mask = wasm_i8x16_bitmask(special);
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#endif
+        for (; i < size; i++) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c == '"' || c == '\\' || c < 32) break;
+        }
+        return i;
+    }
+    
+    // Escape into `out`, copying the runs between escaped characters in one append each
+    void appendEscaped(std::string& out, const char* data, size_t size) {
+        size_t i = 0;
+        while (i < size) {
+            size_t run = plainPrefix(data + i, size - i);
+            out.append(data + i, run);
+            i += run;
+            if (i == size) break;
+            
+            char c = data[i++];
             switch (c) {
-                case '"': result += "\\\""; break;
-                case '\\': result += "\\\\"; break;
-                case '\n': result += "\\n"; break;
-                case '\r': result += "\\r"; break;
-                case '\t': result += "\\t"; break;
-                default:
-                    if (static_cast<unsigned char>(c) < 32) {
-                        char buf[8];
-                        snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
-                        result += buf;
-                    } else {
-                        result += c;
-                    }
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default: {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buf;
+                }
             }
         }
+    }
+    
+    // Append a quoted string without building it separately (the serializer's hot path)
+    void appendString(std::string& out, const char* data, size_t size) {
+        out += '"';
+        appendEscaped(out, data, size);
+        out += '"';
+    }
+    
+    std::string escape(const std::string& s) {
+        std::string result;
+        result.reserve(s.size());
+        appendEscaped(result, s.data(), s.size());
         return result;
     }
 
     std::string string(const std::string& s) {
-        return "\"" + escape(s) + "\"";
+        std::string result;
+        result.reserve(s.size() + 2);
+        appendString(result, s.data(), s.size());
+        return result;
     }
 
     std::string number(int n) {
@@ -97,522 +176,2986 @@ namespace json {
 static std::string g_resultBuffer;
 static std::string g_outputBuffer;
 
-// Module storage for require support
-static std::unordered_map<std::string, std::string> g_modules;
+// Modules for require and analysis. Each source is held once under its canonical name
+// (as registered); an alias index maps every spelling that resolves to it, so require
+// and the analysis FileResolver both resolve a name with one lookup and no allocation.
+// The index is rebuilt whenever a module is added or removed (rare next to lookups), so
+// lookups never write.
+class ModuleRegistry {
+public:
+    struct Module {
+        std::string source;
+        int version = 0;    // document version, 0 until the source is set for analysis
+    };
 
-const char* setResult(std::string result) {
-    g_resultBuffer = std::move(result);
-    return g_resultBuffer.c_str();
-}
+    using Entry = std::pair<const std::string, Module>;
 
-// ============================================================================
-// Execution: Luau VM
-// ============================================================================
+    // Module a require path names, or nullptr
+    const Entry* find(std::string_view path) const {
+        auto it = index.find(stripPathPrefix(path));
+        return it != index.end() ? it->second.entry : nullptr;
+    }
 
-static void serializeValueToJson(lua_State* L, int idx, std::string& out, std::vector<const void*>& seen);
+    Entry* find(std::string_view path) {
+        auto it = index.find(stripPathPrefix(path));
+        return it != index.end() ? it->second.entry : nullptr;
+    }
 
-static void serializeTableToJson(lua_State* L, int idx, std::string& out, std::vector<const void*>& seen) {
-    if (idx < 0) idx = lua_gettop(L) + idx + 1;
-    
-    const void* ptr = lua_topointer(L, idx);
-    for (const void* seenPtr : seen) {
-        if (seenPtr == ptr) {
-            out += "{\"type\":\"circular\"}";
-            return;
-        }
+    // Module registered under exactly this name, or nullptr
+    const Entry* findExact(const std::string& name) const {
+        auto it = modules.find(name);
+        return it != modules.end() ? &*it : nullptr;
     }
-    seen.push_back(ptr);
-    
-    bool hasElements = false;
-    bool isArray = true;
-    int arrayIndex = 1;
-    
-    lua_pushnil(L);
-    while (lua_next(L, idx) != 0) {
-        hasElements = true;
-        if (!lua_isnumber(L, -2) || lua_tonumber(L, -2) != arrayIndex) {
-            isArray = false;
-        }
-        arrayIndex++;
-        lua_pop(L, 1);
+
+    Entry* findExact(const std::string& name) {
+        auto it = modules.find(name);
+        return it != modules.end() ? &*it : nullptr;
     }
-    
-    out += "{\"type\":\"table\",\"isArray\":";
-    out += isArray ? "true" : "false";
-    out += ",\"value\":";
-    
-    if (!hasElements) {
-        out += isArray ? "[]" : "{}";
-        out += "}";
-        seen.pop_back();
-        return;
+
+    Entry& insert(const std::string& name) {
+        auto [it, inserted] = modules.try_emplace(name);
+        if (inserted) rebuildIndex();
+        return *it;
     }
-    
-    if (isArray) {
-        out += "[";
-        bool first = true;
-        lua_pushnil(L);
-        while (lua_next(L, idx) != 0) {
-            if (!first) out += ",";
-            first = false;
-            serializeValueToJson(L, -1, out, seen);
-            lua_pop(L, 1);
-        }
-        out += "]";
-    } else {
-        out += "{";
-        bool first = true;
-        lua_pushnil(L);
-        while (lua_next(L, idx) != 0) {
-            if (!first) out += ",";
-            first = false;
-            
-            int keyType = lua_type(L, -2);
-            std::string keyStr;
-            if (keyType == LUA_TSTRING) {
-                keyStr = lua_tostring(L, -2);
-            } else if (keyType == LUA_TNUMBER) {
-                keyStr = std::to_string(static_cast<long long>(lua_tonumber(L, -2)));
+
+    bool erase(const std::string& name) {
+        bool erased = modules.erase(name) > 0;
+        if (erased) rebuildIndex();
+        return erased;
+    }
+
+    void clear() {
+        modules.clear();
+        aliasNames.clear();
+        index.clear();
+    }
+
+    const std::unordered_map<std::string, Module>& all() const {
+        return modules;
+    }
+
+private:
+    // Lower ranks win when several modules claim a spelling: the exact name, then the
+    // spelling with ".luau" or ".lua" appended, then with its extension replaced
+    struct Alias {
+        Entry* entry;
+        int rank;
+    };
+
+    std::unordered_map<std::string, Module> modules;
+    std::vector<std::string> aliasNames;    // owns the alias keys that aren't module names
+    std::unordered_map<std::string_view, Alias> index;
+
+    static std::string_view stripPathPrefix(std::string_view path) {
+        while (true) {
+            if (path.size() >= 2 && path[0] == '.' && path[1] == '/') {
+                path.remove_prefix(2);
+            } else if (!path.empty() && path[0] == '/') {
+                path.remove_prefix(1);
             } else {
-                size_t len;
-                const char* s = luaL_tolstring(L, -2, &len);
-                if (s) keyStr = std::string(s, len);
-                lua_pop(L, 1);
+                return path;
             }
-            
-            out += json::string(keyStr);
-            out += ":";
-            serializeValueToJson(L, -1, out, seen);
-            lua_pop(L, 1);
         }
-        out += "}";
     }
-    
-    out += "}";
-    seen.pop_back();
-}
 
-static void serializeValueToJson(lua_State* L, int idx, std::string& out, std::vector<const void*>& seen) {
-    switch (lua_type(L, idx)) {
-        case LUA_TNIL:
-            out += "{\"type\":\"nil\"}";
-            break;
-        case LUA_TBOOLEAN:
-            out += "{\"type\":\"boolean\",\"value\":";
-            out += lua_toboolean(L, idx) ? "true" : "false";
-            out += "}";
-            break;
-        case LUA_TNUMBER: {
-            double num = lua_tonumber(L, idx);
-            out += "{\"type\":\"number\",\"value\":";
-            // Handle special float values that aren't valid JSON
-            if (std::isnan(num)) {
-                out += "\"nan\"";
-            } else if (std::isinf(num)) {
-                out += num > 0 ? "\"inf\"" : "\"-inf\"";
-            } else if (num == static_cast<double>(static_cast<long long>(num))) {
-                out += std::to_string(static_cast<long long>(num));
+    static bool stripSuffix(std::string_view& name, std::string_view suffix) {
+        if (name.size() <= suffix.size() || name.substr(name.size() - suffix.size()) != suffix) return false;
+        name.remove_suffix(suffix.size());
+        return true;
+    }
+
+    void rebuildIndex() {
+        std::vector<std::pair<Entry*, int>> pending;    // module and rank of each of aliasNames
+        aliasNames.clear();
+        index.clear();
+
+        auto addAlias = [&](Entry& entry, std::string name, int rank) {
+            aliasNames.push_back(std::move(name));
+            pending.emplace_back(&entry, rank);
+        };
+
+        for (Entry& entry : modules) {
+            std::string_view name = entry.first;
+            std::string_view base = name;
+            if (stripSuffix(base, ".luau")) {
+                addAlias(entry, std::string(base), 1);
+                addAlias(entry, std::string(base) + ".lua", 4);
+            } else if (stripSuffix(base, ".lua")) {
+                addAlias(entry, std::string(base), 2);
+                addAlias(entry, std::string(base) + ".luau", 5);
             } else {
-                char buf[64];
-                snprintf(buf, sizeof(buf), "%.14g", num);
-                out += buf;
+                addAlias(entry, std::string(name) + ".luau", 3);
+                addAlias(entry, std::string(name) + ".lua", 3);
             }
-            out += "}";
-            break;
         }
-        case LUA_TSTRING: {
-            size_t len;
-            const char* s = lua_tolstring(L, idx, &len);
-            out += "{\"type\":\"string\",\"value\":";
-            out += json::string(std::string(s, len));
-            out += "}";
-            break;
+
+        // Views into aliasNames are taken once it is complete and no longer reallocates
+        for (Entry& entry : modules) {
+            index[entry.first] = {&entry, 0};
         }
-        case LUA_TTABLE:
-            serializeTableToJson(L, idx, out, seen);
-            break;
-        case LUA_TFUNCTION:
-            out += "{\"type\":\"function\"}";
-            break;
-        case LUA_TUSERDATA:
-        case LUA_TLIGHTUSERDATA:
-            out += "{\"type\":\"userdata\"}";
-            break;
-        case LUA_TTHREAD:
-            out += "{\"type\":\"thread\"}";
-            break;
-        case LUA_TVECTOR: {
-            const float* v = lua_tovector(L, idx);
-            if (v) {
-                out += "{\"type\":\"vector\",\"value\":[";
-                char buf[64];
-                for (int i = 0; i < LUA_VECTOR_SIZE; i++) {
-                    if (i > 0) out += ",";
-                    if (std::isnan(v[i])) {
-                        out += "\"nan\"";
-                    } else if (std::isinf(v[i])) {
-                        out += v[i] > 0 ? "\"inf\"" : "\"-inf\"";
-                    } else {
-                        snprintf(buf, sizeof(buf), "%.7g", v[i]);
-                        out += buf;
-                    }
-                }
-                out += "]}";
-            } else {
-                out += "{\"type\":\"vector\",\"value\":[0,0,0]}";
+        for (size_t i = 0; i < aliasNames.size(); i++) {
+            auto [it, inserted] = index.try_emplace(aliasNames[i], Alias{pending[i].first, pending[i].second});
+            if (!inserted && pending[i].second < it->second.rank) {
+                it->second = {pending[i].first, pending[i].second};
             }
-            break;
-        }
-        case LUA_TBUFFER: {
-            size_t len = 0;
-            lua_tobuffer(L, idx, &len);
-            out += "{\"type\":\"buffer\",\"size\":";
-            out += std::to_string(len);
-            out += "}";
-            break;
         }
-        default:
-            out += "{\"type\":\"nil\"}";
-            break;
     }
+};
+
+static ModuleRegistry g_moduleRegistry;
+
+// Monotonic clock in milliseconds
+static double nowMs() {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+#endif
 }
 
-static std::vector<std::string> g_printCalls;
+// ============================================================================
+// Tracing
+// ============================================================================
 
-static int playgroundPrint(lua_State* L) {
-    int n = lua_gettop(L);
-    
-    std::string valuesJson = "[";
-    for (int i = 1; i <= n; i++) {
-        if (i > 1) valuesJson += ",";
-        std::vector<const void*> seen;
-        serializeValueToJson(L, i, valuesJson, seen);
+// Optional spans for each phase of the exports, kept as Chrome trace-event "X" (complete)
+// events and drained with luau_take_trace. Timestamps are this worker's performance.now()
+// in microseconds; the host shifts them onto its own timeline.
+static const size_t kTraceMaxEvents = 20000;
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    double startMs;
+    double durationMs;
+    std::string args; // "key":value pairs, without braces
+};
+
+struct TraceState {
+    bool enabled = false;
+    int pid = 1;
+    uint32_t dropped = 0;
+    std::vector<TraceEvent> events;
+};
+
+static TraceState g_trace;
+
+// Records a span from construction to destruction while tracing is enabled
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category)
+        : name(name)
+        , category(category)
+        , active(g_trace.enabled)
+        , startMs(active ? nowMs() : 0.0)
+    {
     }
-    valuesJson += "]";
-    g_printCalls.push_back(valuesJson);
     
-    // Plain text fallback
-    std::string line;
+    ~TraceSpan() {
+        end();
+    }
     
-    for (int i = 1; i <= n; i++) {
-        size_t len;
-        const char* s = luaL_tolstring(L, i, &len);
-        if (s) {
-            if (i > 1) line += "\t";
-            line += std::string(s, len);
+    // Close the span before the end of its scope
+    void end() {
+        if (!active) return;
+        active = false;
+        if (!g_trace.enabled) return;
+        
+        if (g_trace.events.size() >= kTraceMaxEvents) {
+            g_trace.dropped++;
+            return;
         }
-        lua_pop(L, 1);
+        g_trace.events.push_back({name, category, startMs, nowMs() - startMs, std::move(args)});
     }
     
-    if (!g_outputBuffer.empty()) {
-        g_outputBuffer += "\n";
+    void arg(const char* key, double value) {
+        if (!active) return;
+        std::ostringstream out;
+        out << value;
+        append(key, out.str());
     }
-    g_outputBuffer += line;
     
-    return 0;
-}
-
-// Normalize a module path by removing ./ prefix and handling extensions
-static std::string normalizeModulePath(const std::string& path) {
-    std::string result = path;
+    void arg(const char* key, bool value) {
+        if (active) append(key, json::boolean(value));
+    }
     
-    // Remove leading ./
-    while (result.length() >= 2 && result[0] == '.' && result[1] == '/') {
-        result = result.substr(2);
+    void arg(const char* key, const std::string& value) {
+        if (active) append(key, json::string(value));
     }
     
-    // Remove leading /
-    while (!result.empty() && result[0] == '/') {
-        result = result.substr(1);
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    double startMs;
+    std::string args;
+    
+    void append(const char* key, const std::string& value) {
+        if (!args.empty()) args += ",";
+        args += json::string(key) + ":" + value;
     }
+};
+
+const char* setResult(std::string result) {
+    TraceSpan span("setResult", "result");
+    span.arg("bytes", static_cast<double>(result.size()));
     
-    return result;
+    g_resultBuffer = std::move(result);
+    return g_resultBuffer.c_str();
+}
+
+/**
+ * Enable span recording for subsequent calls.
+ * @param pid Process id stamped on the events, so traces of several workers can be merged
+ */
+EXPORT void luau_set_tracing(bool enabled, int pid) {
+    g_trace.enabled = enabled;
+    g_trace.pid = pid;
+    if (!enabled) {
+        g_trace.events.clear();
+        g_trace.dropped = 0;
+    }
 }
 
-// Try to find a module with various path variations
-static std::unordered_map<std::string, std::string>::iterator findModule(const std::string& moduleName) {
-    std::string normalized = normalizeModulePath(moduleName);
+/**
+ * Drain the recorded spans.
+ * Returns: { "traceEvents": [{ name, cat, ph: "X", ts, dur, pid, tid, args }], "droppedEvents": number }
+ */
+EXPORT const char* luau_take_trace() {
+    std::string out = "{\"traceEvents\":[";
+    char timing[64];
+    for (size_t i = 0; i < g_trace.events.size(); i++) {
+        const TraceEvent& event = g_trace.events[i];
+        if (i > 0) out += ",";
+        out += "{\"name\":" + json::string(event.name);
+        out += ",\"cat\":" + json::string(event.category);
+        snprintf(timing, sizeof(timing), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", event.startMs * 1000.0, event.durationMs * 1000.0);
+        out += timing;
+        out += ",\"pid\":" + std::to_string(g_trace.pid) + ",\"tid\":1";
+        out += ",\"args\":{" + event.args + "}}";
+    }
+    out += "],\"droppedEvents\":" + std::to_string(g_trace.dropped) + "}";
     
-    // Try exact match first
-    auto it = g_modules.find(normalized);
-    if (it != g_modules.end()) return it;
+    g_trace.events.clear();
+    g_trace.dropped = 0;
     
-    // Try with .luau extension
-    it = g_modules.find(normalized + ".luau");
-    if (it != g_modules.end()) return it;
+    // Not traced itself, so a drain doesn't leave an event behind
+    g_resultBuffer = std::move(out);
+    return g_resultBuffer.c_str();
+}
+
+// ============================================================================
+// Binary Result Encoding
+// ============================================================================
+
+// Optional compact encoding for luau_execute, luau_get_diagnostics, luau_autocomplete
+// and luau_hover, read by the host as a DataView over wasm memory.
+//
+// Layout (little endian), schema version 2:
+//   header   u32 magic 'LPBR', u16 version, u16 kind, u32 recordCount, u32 stringCount, u32 stringTableOffset
+//   records  u32 byteLength, then kind-specific fields (u8/u32/i32; strings are u32 string table indices;
+//            print records are binary values, see BinaryValueWriter)
+//   strings  u32 byteLength, then UTF-8 bytes (not NUL terminated)
+//
+// Unknown trailing record fields are skipped using byteLength, so fields can be appended
+// without a version bump.
+enum class ResultEncoding { Json = 0, Binary = 1 };
+
+enum class BinaryResultKind : uint16_t {
+    Execute = 1,
+    Diagnostics = 2,
+    Autocomplete = 3,
+    Hover = 4,
+    PrintBatch = 5,     // streamed print records (Module.onPrintBatchBinary)
+};
+
+static const uint32_t kBinaryResultMagic = 0x5242504C; // "LPBR"
+// 2: print records hold binary values (BinaryValueWriter) instead of JSON strings
+static const uint16_t kBinaryResultVersion = 2;
+static const uint32_t kNoString = 0xFFFFFFFF;
+
+static ResultEncoding g_resultEncoding = ResultEncoding::Json;
+static std::string g_binaryResultBuffer;
+
+class BinaryResultWriter {
+public:
+    explicit BinaryResultWriter(BinaryResultKind kind) : kind(kind) {}
     
-    // Try with .lua extension
-    it = g_modules.find(normalized + ".lua");
-    if (it != g_modules.end()) return it;
+    void beginRecord() {
+        recordStart = records.size();
+        u32(0); // patched in endRecord
+        recordCount++;
+    }
     
-    // Try without extension if it has one
-    size_t dotPos = normalized.rfind('.');
-    if (dotPos != std::string::npos) {
-        std::string withoutExt = normalized.substr(0, dotPos);
-        it = g_modules.find(withoutExt);
-        if (it != g_modules.end()) return it;
-        
-        it = g_modules.find(withoutExt + ".luau");
-        if (it != g_modules.end()) return it;
-        
-        it = g_modules.find(withoutExt + ".lua");
-        if (it != g_modules.end()) return it;
+    void endRecord() {
+        uint32_t length = static_cast<uint32_t>(records.size() - recordStart - 4);
+        memcpy(&records[recordStart], &length, 4);
     }
     
-    return g_modules.end();
-}
-
-// Custom require function that loads from g_modules
-static int playgroundRequire(lua_State* L) {
-    const char* moduleName = luaL_checkstring(L, 1);
+    void u8(uint8_t v) { records.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) { append(records, v); }
+    void i32(int32_t v) { append(records, v); }
     
-    // Find the module with path normalization
-    auto it = findModule(moduleName);
+    void str(const std::string& s) { u32(intern(s)); }
+    void noString() { u32(kNoString); }
+    void bytes(const std::string& data) { records += data; }
     
-    if (it == g_modules.end()) {
-        // List available modules for debugging
-        std::string available;
-        for (const auto& [name, _] : g_modules) {
-            if (!available.empty()) available += ", ";
-            available += "'" + name + "'";
+    // Assemble header, records and string table into the shared result buffer
+    const char* finish() {
+        return finishInto(g_binaryResultBuffer);
+    }
+    
+    const char* finishInto(std::string& out) {
+        TraceSpan span("setResult", "result");
+        
+        out.clear();
+        
+        const uint32_t headerSize = 20;
+        uint32_t stringTableOffset = headerSize + static_cast<uint32_t>(records.size());
+        
+        append(out, kBinaryResultMagic);
+        append(out, kBinaryResultVersion);
+        append(out, static_cast<uint16_t>(kind));
+        append(out, recordCount);
+        append(out, static_cast<uint32_t>(strings.size()));
+        append(out, stringTableOffset);
+        out += records;
+        
+        for (const std::string& s : strings) {
+            append(out, static_cast<uint32_t>(s.size()));
+            out += s;
         }
-        luaL_error(L, "module '%s' not found\navailable modules: %s", moduleName, available.c_str());
-        return 0;
+        
+        return out.data();
     }
     
-    const std::string& source = it->second;
+private:
+    BinaryResultKind kind;
+    std::string records;
+    size_t recordStart = 0;
+    uint32_t recordCount = 0;
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIndex;
     
-    // Compile the module
-    size_t bytecodeSize = 0;
-    char* bytecode = luau_compile(source.c_str(), source.size(), nullptr, &bytecodeSize);
+    template<typename T>
+    static void append(std::string& out, T v) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &v, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
     
-    if (!bytecode) {
-        luaL_error(L, "failed to compile module '%s'", moduleName);
-        return 0;
+    uint32_t intern(const std::string& s) {
+        auto it = stringIndex.find(s);
+        if (it != stringIndex.end()) return it->second;
+        
+        uint32_t index = static_cast<uint32_t>(strings.size());
+        strings.push_back(s);
+        stringIndex.emplace(s, index);
+        return index;
     }
+};
+
+/**
+ * Select the result encoding for the query exports.
+ * @param encoding 0 = JSON string (default), 1 = binary (pointer; size from luau_result_size)
+ */
+EXPORT void luau_set_result_encoding(int encoding) {
+    g_resultEncoding = encoding == 1 ? ResultEncoding::Binary : ResultEncoding::Json;
+}
+
+/**
+ * Byte length of the most recent binary result.
+ */
+EXPORT int luau_result_size() {
+    return static_cast<int>(g_binaryResultBuffer.size());
+}
+
+// ============================================================================
+// Bytecode Cache
+// ============================================================================
+
+// Compiled chunks keyed by source hash and compile options, shared by
+// luau_execute, require and luau_dump_bytecode within this module instance
+static const size_t kBytecodeCacheCapacity = 64;
+
+struct CachedBytecode {
+    std::string source;
+    int optimizationLevel = 0;
+    int debugLevel = 0;
+    int typeInfoLevel = 0;
+    int coverageLevel = 0;
+    std::string vectorLib;
+    std::string vectorCtor;
+    std::string vectorType;
+    std::string bytecode;
+    uint64_t lastUse = 0;
+};
+
+static std::unordered_map<uint64_t, CachedBytecode> g_bytecodeCache;
+static uint64_t g_bytecodeCacheClock = 0;
+
+// FNV-1a over the source text followed by the options that affect codegen
+static uint64_t hashCompileInput(const std::string& source, const Luau::CompileOptions& options) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](unsigned char c) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    };
     
-    // Load and execute the module
-    std::string chunkName = std::string("=") + moduleName;
-    int loadResult = luau_load(L, chunkName.c_str(), bytecode, bytecodeSize, 0);
-    free(bytecode);
+    for (char c : source) mix(static_cast<unsigned char>(c));
     
-    if (loadResult != 0) {
-        lua_error(L);
-        return 0;
+    mix(static_cast<unsigned char>(options.optimizationLevel));
+    mix(static_cast<unsigned char>(options.debugLevel));
+    mix(static_cast<unsigned char>(options.typeInfoLevel));
+    mix(static_cast<unsigned char>(options.coverageLevel));
+    
+    // Vector names change how vector constructors compile; each is NUL terminated so
+    // ("ab", "") and ("a", "b") hash differently
+    for (const char* name : {options.vectorLib, options.vectorCtor, options.vectorType}) {
+        for (const char* c = name; c && *c; c++) mix(static_cast<unsigned char>(*c));
+        mix(0);
+    }
+    return hash;
+}
+
+static std::string optionString(const char* value) {
+    return value ? value : "";
+}
+
+static bool matchesCompileInput(const CachedBytecode& entry, const std::string& source, const Luau::CompileOptions& options) {
+    return entry.optimizationLevel == options.optimizationLevel &&
+           entry.debugLevel == options.debugLevel &&
+           entry.typeInfoLevel == options.typeInfoLevel &&
+           entry.coverageLevel == options.coverageLevel &&
+           entry.vectorLib == optionString(options.vectorLib) &&
+           entry.vectorCtor == optionString(options.vectorCtor) &&
+           entry.vectorType == optionString(options.vectorType) &&
+           entry.source == source;
+}
+
+static void evictLeastRecentBytecode() {
+    auto oldest = g_bytecodeCache.begin();
+    for (auto it = g_bytecodeCache.begin(); it != g_bytecodeCache.end(); ++it) {
+        if (it->second.lastUse < oldest->second.lastUse) oldest = it;
     }
+    if (oldest != g_bytecodeCache.end()) g_bytecodeCache.erase(oldest);
+}
+
+// Record bytecode produced elsewhere (e.g. by the dump path) so later runs can reuse it
+static const std::string& storeCachedBytecode(const std::string& source, const Luau::CompileOptions& options, std::string bytecode) {
+    uint64_t key = hashCompileInput(source, options);
     
-    // Execute the module
-    lua_call(L, 0, 1);
+    auto it = g_bytecodeCache.find(key);
+    if (it == g_bytecodeCache.end()) {
+        if (g_bytecodeCache.size() >= kBytecodeCacheCapacity) evictLeastRecentBytecode();
+        it = g_bytecodeCache.emplace(key, CachedBytecode{}).first;
+    }
     
-    return 1;
+    CachedBytecode& entry = it->second;
+    entry.source = source;
+    entry.optimizationLevel = options.optimizationLevel;
+    entry.debugLevel = options.debugLevel;
+    entry.typeInfoLevel = options.typeInfoLevel;
+    entry.coverageLevel = options.coverageLevel;
+    entry.vectorLib = optionString(options.vectorLib);
+    entry.vectorCtor = optionString(options.vectorCtor);
+    entry.vectorType = optionString(options.vectorType);
+    entry.bytecode = std::move(bytecode);
+    entry.lastUse = ++g_bytecodeCacheClock;
+    return entry.bytecode;
 }
 
-// Error handler that generates stack traces
-static int errorHandler(lua_State* L) {
-    // Get the error message
-    std::string errorMsg;
+// Luau::compile with the parse and compile phases traced separately
+static std::string compileTraced(const std::string& source, const Luau::CompileOptions& options) {
+    Luau::Allocator allocator;
+    Luau::AstNameTable names(allocator);
     
-    if (lua_isstring(L, 1)) {
-        const char* msg = lua_tostring(L, 1);
-        errorMsg = msg ? msg : "unknown error";
-    } else {
-        // Try to convert to string
-        const char* typeName = lua_typename(L, lua_type(L, 1));
-        errorMsg = std::string("(error object is a ") + typeName + " value)";
+    Luau::ParseResult parseResult = [&] {
+        TraceSpan span("parse", "compile");
+        span.arg("bytes", static_cast<double>(source.size()));
+        return Luau::Parser::parse(source.c_str(), source.size(), names, allocator, Luau::ParseOptions{});
+    }();
+    
+    // Error text matches Luau::compile (one message, 1-based line)
+    if (!parseResult.errors.empty()) {
+        const Luau::ParseError& error = parseResult.errors.front();
+        return Luau::BytecodeBuilder::getError(":" + std::to_string(error.getLocation().begin.line + 1) + ": " + error.what());
     }
     
-    // Build stack trace manually since Luau doesn't have luaL_traceback
-    std::string trace = errorMsg;
-    trace += "\nstack traceback:";
+    TraceSpan span("compile", "compile");
+    try {
+        Luau::BytecodeBuilder bcb;
+        Luau::compileOrThrow(bcb, parseResult, names, options);
+        return bcb.getBytecode();
+    } catch (Luau::CompileError& e) {
+        return Luau::BytecodeBuilder::getError(":" + std::to_string(e.getLocation().begin.line + 1) + ": " + e.what());
+    }
+}
+
+// Compile or fetch from cache. Compile errors are encoded in the bytecode and surface from luau_load.
+// The returned reference stays valid until the next cache insertion.
+static const std::string& compileCached(const std::string& source, const Luau::CompileOptions& options) {
+    TraceSpan span("compileCached", "compile");
     
+    auto it = g_bytecodeCache.find(hashCompileInput(source, options));
+    if (it != g_bytecodeCache.end() && matchesCompileInput(it->second, source, options)) {
+        it->second.lastUse = ++g_bytecodeCacheClock;
+        span.arg("cached", true);
+        return it->second.bytecode;
+    }
+    
+    span.arg("cached", false);
+    return storeCachedBytecode(source, options, compileTraced(source, options));
+}
+
+// Compile options for executed code, set by luau_set_compile_options and kept until changed
+struct ExecutionCompileConfig {
+    int optimizationLevel = 1;
+    int debugLevel = 1;
+    int typeInfoLevel = 0;
+    int coverageLevel = 0;
+    // Owned here; CompileOptions only points at them ("" = unset)
+    std::string vectorLib;
+    std::string vectorCtor;
+    std::string vectorType;
+};
+
+static ExecutionCompileConfig g_executionCompile;
+
+// Set by luau_execute for the duration of a run with coverage; only then is code compiled
+// with coverage and are chunks tracked (so benchmarks and inspection never add to it)
+static bool g_coverageRun = false;
+
+// Options used for executed code (main chunk and required modules)
+static Luau::CompileOptions executionCompileOptions() {
+    const ExecutionCompileConfig& config = g_executionCompile;
+    
+    Luau::CompileOptions options;
+    options.optimizationLevel = config.optimizationLevel;
+    options.debugLevel = config.debugLevel;
+    options.typeInfoLevel = config.typeInfoLevel;
+    options.coverageLevel = g_coverageRun ? config.coverageLevel : 0;
+    options.vectorLib = config.vectorLib.empty() ? nullptr : config.vectorLib.c_str();
+    options.vectorCtor = config.vectorCtor.empty() ? nullptr : config.vectorCtor.c_str();
+    options.vectorType = config.vectorType.empty() ? nullptr : config.vectorType.c_str();
+    return options;
+}
+
+/**
+ * Set the compile options used by luau_execute, require and luau_benchmark.
+ * They stay in effect until changed; bytecode is cached per option set.
+ * @param optimizationLevel 0-2 (default 1)
+ * @param debugLevel 0-2 (default 1)
+ * @param typeInfoLevel 0-1 (default 0)
+ * @param coverageLevel 0-2 (default 0, see luau_set_coverage; only luau_execute uses it)
+ * @param vectorLib Library of the vector constructor, e.g. "Vector3" ("" = none)
+ * @param vectorCtor Vector constructor function, e.g. "new" ("" = none)
+ * @param vectorType Vector type name for type annotations ("" = none)
+ */
+EXPORT void luau_set_compile_options(int optimizationLevel, int debugLevel, int typeInfoLevel, int coverageLevel,
+                                     const char* vectorLib, const char* vectorCtor, const char* vectorType) {
+    ExecutionCompileConfig& config = g_executionCompile;
+    config.optimizationLevel = std::clamp(optimizationLevel, 0, 2);
+    config.debugLevel = std::clamp(debugLevel, 0, 2);
+    config.typeInfoLevel = std::clamp(typeInfoLevel, 0, 1);
+    config.coverageLevel = std::clamp(coverageLevel, 0, 2);
+    config.vectorLib = optionString(vectorLib);
+    config.vectorCtor = optionString(vectorCtor);
+    config.vectorType = optionString(vectorType);
+}
+
+// ============================================================================
+// Coverage
+// ============================================================================
+
+// Chunks loaded by the current coverage run, collected once it finishes
+struct CoverageChunk {
+    std::string name;
+    int ref = LUA_NOREF;
+};
+
+static std::vector<CoverageChunk> g_coverageChunks;
+static std::string g_coverageJson;
+
+// Keep the chunk on top of the stack alive until coverage is collected
+static void trackCoverageChunk(lua_State* L, const std::string& name) {
+    if (!g_coverageRun) return;
+    
+    lua_pushvalue(L, -1);
+    g_coverageChunks.push_back({name, lua_ref(L, -1)});
+    lua_pop(L, 1);
+}
+
+// Drop chunks left by a run that didn't collect them; L is null once their state is closed
+static void releaseCoverageChunks(lua_State* L) {
+    if (L) {
+        for (const CoverageChunk& chunk : g_coverageChunks) {
+            lua_unref(L, chunk.ref);
+        }
+    }
+    g_coverageChunks.clear();
+}
+
+// Hits per line of one chunk; a line shared by nested functions keeps its highest count
+using LineHits = std::map<int, int>;
+
+static void mergeCoverage(void* context, const char* function, int linedefined, int depth, const int* hits, size_t size) {
+    LineHits& lines = *static_cast<LineHits*>(context);
+    
+    for (size_t line = 0; line < size; line++) {
+        if (hits[line] < 0) continue; // not executable
+        
+        auto [it, inserted] = lines.emplace(static_cast<int>(line), hits[line]);
+        if (!inserted) it->second = std::max(it->second, hits[line]);
+    }
+}
+
+// { level, files: { chunk: { lines: [line, hits, line, hits, ...], covered, total } } }
+// Lines are 1-based and ascending; only executable lines are listed
+static void collectCoverage(lua_State* L) {
+    g_coverageJson.clear();
+    if (!g_coverageRun) return;
+    
+    std::map<std::string, LineHits> files;
+    for (const CoverageChunk& chunk : g_coverageChunks) {
+        lua_getref(L, chunk.ref);
+        lua_getcoverage(L, -1, &files[chunk.name], mergeCoverage);
+        lua_pop(L, 1);
+        lua_unref(L, chunk.ref);
+    }
+    g_coverageChunks.clear();
+    
+    std::string out = "{\"level\":" + std::to_string(g_executionCompile.coverageLevel) + ",\"files\":{";
+    bool firstFile = true;
+    for (const auto& [name, lines] : files) {
+        if (!firstFile) out += ",";
+        firstFile = false;
+        
+        int covered = 0;
+        out += json::string(name) + ":{\"lines\":[";
+        bool firstLine = true;
+        for (const auto& [line, hits] : lines) {
+            if (!firstLine) out += ",";
+            firstLine = false;
+            out += std::to_string(line) + "," + std::to_string(hits);
+            if (hits > 0) covered++;
+        }
+        out += "],\"covered\":" + std::to_string(covered);
+        out += ",\"total\":" + std::to_string(lines.size()) + "}";
+    }
+    out += "}}";
+    
+    g_coverageJson = std::move(out);
+}
+
+/**
+ * Compile executed code with coverage instrumentation; the other compile options are kept.
+ * @param level 0 = off, 1 = statements, 2 = statements and expressions
+ */
+EXPORT void luau_set_coverage(int level) {
+    g_executionCompile.coverageLevel = std::clamp(level, 0, 2);
+}
+
+// ============================================================================
+// Execution: Luau VM
+// ============================================================================
+
+// Budgets for serializing printed values; subtrees past them become expandable handles
+struct SerializeLimits {
+    int maxDepth = 8;                 // nested tables inlined below a printed value
+    int maxWidth = 500;               // entries inlined per table
+    size_t maxBytes = 256 * 1024;     // encoded bytes per print call
+};
+
+static SerializeLimits g_serializeLimits;
+
+// Tables cut off by a budget, retained (registry refs) until the next run so the
+// host can expand them with luau_inspect_value
+static std::vector<int> g_inspectRefs;
+static std::unordered_map<const void*, int> g_inspectHandles;
+
+static void releaseInspectHandles(lua_State* L) {
+    for (int ref : g_inspectRefs) {
+        lua_unref(L, ref);
+    }
+    g_inspectRefs.clear();
+    g_inspectHandles.clear();
+}
+
+static int retainInspectHandle(lua_State* L, int idx) {
+    const void* ptr = lua_topointer(L, idx);
+    auto it = g_inspectHandles.find(ptr);
+    if (it != g_inspectHandles.end()) return it->second;
+    
+    int handle = static_cast<int>(g_inspectRefs.size());
+    g_inspectRefs.push_back(lua_ref(L, idx));
+    g_inspectHandles[ptr] = handle;
+    return handle;
+}
+
+static void appendNumber(std::string& out, double num) {
+    // Handle special float values that aren't valid JSON
+    if (std::isnan(num)) {
+        out += "\"nan\"";
+    } else if (std::isinf(num)) {
+        out += num > 0 ? "\"inf\"" : "\"-inf\"";
+    } else if (num == static_cast<double>(static_cast<long long>(num))) {
+        out += std::to_string(static_cast<long long>(num));
+    } else {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.14g", num);
+        out += buf;
+    }
+}
+
+// Display form of a table key
+static std::string tableKeyString(lua_State* L, int idx) {
+    switch (lua_type(L, idx)) {
+        case LUA_TSTRING: {
+            size_t len;
+            const char* s = lua_tolstring(L, idx, &len);
+            return std::string(s, len);
+        }
+        case LUA_TNUMBER: {
+            std::string key;
+            appendNumber(key, lua_tonumber(L, idx));
+            return key;
+        }
+        default: {
+            std::string key;
+            size_t len;
+            const char* s = luaL_tolstring(L, idx, &len);
+            if (s) key = std::string(s, len);
+            lua_pop(L, 1);
+            return key;
+        }
+    }
+}
+
+// JSON form of printed values (JSON results and luau_inspect_value).
+// Tables are emitted as arrays until the first non-sequential key, at which point the
+// entries written so far are rewritten in object form.
+class JsonValueWriter {
+public:
+    explicit JsonValueWriter(std::string& out) : out(out) {}
+    
+    // A table or userdata being written
+    struct Object {
+        size_t valueStart = 0;
+        size_t elementStart = 0;
+        int entries = 0;
+        std::vector<std::pair<size_t, size_t>> elements;    // array entries, until converted
+    };
+    
+    std::string& out;
+    
+    void beginValues() { out += "["; }
+    void separator() { out += ","; }
+    void endValues() { out += "]"; }
+    
+    void nil() { out += "{\"type\":\"nil\"}"; }
+    
+    void boolean(bool value) {
+        out += "{\"type\":\"boolean\",\"value\":";
+        out += value ? "true" : "false";
+        out += "}";
+    }
+    
+    void number(double value) {
+        out += "{\"type\":\"number\",\"value\":";
+        appendNumber(out, value);
+        out += "}";
+    }
+    
+    void string(const char* s, size_t len) {
+        out += "{\"type\":\"string\",\"value\":";
+        json::appendString(out, s, len);
+        out += "}";
+    }
+    
+    void function() { out += "{\"type\":\"function\"}"; }
+    void thread() { out += "{\"type\":\"thread\"}"; }
+    void circular() { out += "{\"type\":\"circular\"}"; }
+    
+    void vector(const float* v) {
+        out += "{\"type\":\"vector\",\"value\":[";
+        char buf[64];
+        for (int i = 0; i < LUA_VECTOR_SIZE; i++) {
+            if (i > 0) out += ",";
+            if (std::isnan(v[i])) {
+                out += "\"nan\"";
+            } else if (std::isinf(v[i])) {
+                out += v[i] > 0 ? "\"inf\"" : "\"-inf\"";
+            } else {
+                snprintf(buf, sizeof(buf), "%.7g", v[i]);
+                out += buf;
+            }
+        }
+        out += "]}";
+    }
+    
+    void buffer(size_t size) {
+        out += "{\"type\":\"buffer\",\"size\":";
+        out += std::to_string(size);
+        out += "}";
+    }
+    
+    Object beginUserdata() {
+        out += "{\"type\":\"userdata\"";
+        return Object{};
+    }
+    
+    // A table past the depth or byte budget, written without entries
+    Object beginCutOffTable() {
+        out += "{\"type\":\"table\",\"isArray\":false,\"value\":{}";
+        return Object{};
+    }
+    
+    Object beginTable() {
+        out += "{\"type\":\"table\",\"value\":[";
+        Object table;
+        table.valueStart = out.size() - 1;
+        return table;
+    }
+    
+    void beginElement(Object& table) {
+        if (table.entries++ > 0) out += ",";
+        table.elementStart = out.size();
+    }
+    
+    void endElement(Object& table) {
+        table.elements.emplace_back(table.elementStart, out.size());
+    }
+    
+    void key(Object& table, const std::string& key) {
+        if (table.entries++ > 0) out += ",";
+        json::appendString(out, key.data(), key.size());
+        out += ":";
+    }
+    
+    // Rewrite "[v1,v2,...]" emitted so far as "{"k1":v1,"k2":v2,...}"
+    void convertToObject(Object& table, int offset) {
+        std::string rebuilt = "{";
+        for (size_t i = 0; i < table.elements.size(); i++) {
+            if (i > 0) rebuilt += ",";
+            rebuilt += "\"";
+            rebuilt += std::to_string(offset + static_cast<int>(i) + 1);
+            rebuilt += "\":";
+            rebuilt.append(out, table.elements[i].first, table.elements[i].second - table.elements[i].first);
+        }
+        
+        out.resize(table.valueStart);
+        out += rebuilt;
+        table.elements.clear();
+    }
+    
+    void endEntries(Object& table, bool isArray) {
+        out += isArray ? "]" : "}";
+        out += ",\"isArray\":";
+        out += isArray ? "true" : "false";
+    }
+    
+    void truncation(Object& table, int handle, int offset) {
+        out += ",\"truncated\":{\"handle\":";
+        out += std::to_string(handle);
+        out += ",\"offset\":";
+        out += std::to_string(offset);
+        out += "}";
+    }
+    
+    void toString(Object& object, const std::string& text) {
+        out += ",\"tostring\":";
+        json::appendString(out, text.data(), text.size());
+    }
+    
+    void end(Object& object) { out += "}"; }
+};
+
+// Binary form of printed values, the print records of binary results (see binary.ts).
+// Each value is a u8 tag and its payload; strings are inline (u32 byteLength + UTF-8):
+//   nil, function, thread, circular  no payload
+//   boolean  u8                      number  f64                 string  str
+//   vector   u8 count, f32 * count   buffer  u32 size
+//   userdata u8 flags, [str tostring]
+//   table    u8 flags, u32 entryCount, entries (u32 key byteLength + key bytes, or
+//            0xFFFFFFFF for the next array index, then the value),
+//            [u32 handle, u32 offset if truncated], [str tostring]
+// Keys are the display keys of the JSON form. Print records always start at the
+// table's first entry, so keyless entries of an object table are keyed by position.
+class BinaryValueWriter {
+public:
+    explicit BinaryValueWriter(std::string& out) : out(out) {}
+    
+    enum Tag : uint8_t {
+        Nil = 0, Boolean = 1, Number = 2, String = 3, Table = 4, Function = 5,
+        Userdata = 6, Thread = 7, Circular = 8, Vector = 9, Buffer = 10,
+    };
+    
+    enum Flags : uint8_t {
+        IsArray = 1 << 0,
+        Truncated = 1 << 1,
+        HasToString = 1 << 2,
+    };
+    
+    struct Object {
+        size_t flagsPos = 0;
+        size_t countPos = 0;
+        uint32_t entries = 0;
+    };
+    
+    std::string& out;
+    
+    // A record holds its values back to back; its byteLength tells where they end
+    void beginValues() {}
+    void separator() {}
+    void endValues() {}
+    
+    void nil() { tag(Nil); }
+    
+    void boolean(bool value) {
+        tag(Boolean);
+        out += static_cast<char>(value ? 1 : 0);
+    }
+    
+    void number(double value) {
+        tag(Number);
+        append(value);
+    }
+    
+    void string(const char* s, size_t len) {
+        tag(String);
+        str(s, len);
+    }
+    
+    void function() { tag(Function); }
+    void thread() { tag(Thread); }
+    void circular() { tag(Circular); }
+    
+    void vector(const float* v) {
+        tag(Vector);
+        out += static_cast<char>(LUA_VECTOR_SIZE);
+        for (int i = 0; i < LUA_VECTOR_SIZE; i++) append(v[i]);
+    }
+    
+    void buffer(size_t size) {
+        tag(Buffer);
+        append(static_cast<uint32_t>(size));
+    }
+    
+    Object beginUserdata() {
+        tag(Userdata);
+        Object object;
+        object.flagsPos = out.size();
+        out += '\0';
+        return object;
+    }
+    
+    Object beginCutOffTable() {
+        return beginTable();
+    }
+    
+    Object beginTable() {
+        tag(Table);
+        Object table;
+        table.flagsPos = out.size();
+        out += '\0';
+        table.countPos = out.size();
+        append(uint32_t(0));
+        return table;
+    }
+    
+    void beginElement(Object& table) {
+        table.entries++;
+        append(kNoKey);
+    }
+    
+    void endElement(Object& table) {}
+    
+    void key(Object& table, const std::string& key) {
+        table.entries++;
+        str(key.data(), key.size());
+    }
+    
+    void convertToObject(Object& table, int offset) {}
+    
+    void endEntries(Object& table, bool isArray) {
+        if (isArray) out[table.flagsPos] |= IsArray;
+        memcpy(&out[table.countPos], &table.entries, 4);
+    }
+    
+    void truncation(Object& table, int handle, int offset) {
+        out[table.flagsPos] |= Truncated;
+        append(static_cast<uint32_t>(handle));
+        append(static_cast<uint32_t>(offset));
+    }
+    
+    void toString(Object& object, const std::string& text) {
+        out[object.flagsPos] |= HasToString;
+        str(text.data(), text.size());
+    }
+    
+    void end(Object& object) {}
+    
+private:
+    static const uint32_t kNoKey = 0xFFFFFFFF;
+    
+    void tag(Tag t) { out += static_cast<char>(t); }
+    
+    void str(const char* s, size_t len) {
+        append(static_cast<uint32_t>(len));
+        out.append(s, len);
+    }
+    
+    template<typename T>
+    void append(T v) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &v, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+};
+
+// Single-pass serializer for Luau values, writing JSON or binary records (Writer)
+template<typename Writer>
+class ValueSerializer {
+public:
+    ValueSerializer(lua_State* L, std::string& out, const SerializeLimits& limits)
+        : L(L), w(out), limits(limits), startSize(out.size()) {}
+    
+    // __tostring result of the last top-level value, if it had one; lets the
+    // plain text view reuse it instead of invoking the metamethod again
+    std::optional<std::string> capturedToString;
+    
+    void beginValues() { w.beginValues(); }
+    void separator() { w.separator(); }
+    void endValues() { w.endValues(); }
+    
+    void value(int idx, int depth = 0) {
+        if (depth == 0) {
+            capturedToString.reset();
+            captureToString = true;
+        }
+        
+        switch (lua_type(L, idx)) {
+            case LUA_TNIL:
+                w.nil();
+                break;
+            case LUA_TBOOLEAN:
+                w.boolean(lua_toboolean(L, idx));
+                break;
+            case LUA_TNUMBER:
+                w.number(lua_tonumber(L, idx));
+                break;
+            case LUA_TSTRING: {
+                size_t len;
+                const char* s = lua_tolstring(L, idx, &len);
+                w.string(s, len);
+                break;
+            }
+            case LUA_TTABLE:
+                table(idx, depth);
+                break;
+            case LUA_TFUNCTION:
+                w.function();
+                break;
+            case LUA_TUSERDATA:
+            case LUA_TLIGHTUSERDATA: {
+                typename Writer::Object userdata = w.beginUserdata();
+                if (depth == 0 && captureToString) appendToString(idx, userdata);
+                w.end(userdata);
+                break;
+            }
+            case LUA_TTHREAD:
+                w.thread();
+                break;
+            case LUA_TVECTOR: {
+                const float* v = lua_tovector(L, idx);
+                const float zero[LUA_VECTOR_SIZE] = {};
+                w.vector(v ? v : zero);
+                break;
+            }
+            case LUA_TBUFFER: {
+                size_t len = 0;
+                lua_tobuffer(L, idx, &len);
+                w.buffer(len);
+                break;
+            }
+            default:
+                w.nil();
+                break;
+        }
+        
+        if (depth == 0) captureToString = false;
+    }
+    
+    // Serialize a table, skipping the first `offset` entries (continuation of a truncated table)
+    void table(int idx, int depth, int offset = 0) {
+        if (idx < 0) idx = lua_gettop(L) + idx + 1;
+        
+        const void* ptr = lua_topointer(L, idx);
+        if (ancestors.count(ptr)) {
+            w.circular();
+            return;
+        }
+        
+        if (depth >= limits.maxDepth || overBudget() || !lua_checkstack(L, 4)) {
+            typename Writer::Object cutOff = w.beginCutOffTable();
+            w.truncation(cutOff, retainInspectHandle(L, idx), 0);
+            if (depth == 0 && captureToString) appendToString(idx, cutOff);
+            w.end(cutOff);
+            return;
+        }
+        
+        ancestors.insert(ptr);
+        
+        typename Writer::Object table = w.beginTable();
+        
+        bool isArray = true;
+        bool truncated = false;
+        int visited = 0;
+        int emitted = 0;
+        
+        lua_pushnil(L);
+        while (lua_next(L, idx) != 0) {
+            visited++;
+            
+            if (isArray && (lua_type(L, -2) != LUA_TNUMBER || lua_tonumber(L, -2) != visited)) {
+                isArray = false;
+                w.convertToObject(table, offset);
+            }
+            
+            if (visited <= offset) {
+                lua_pop(L, 1);
+                continue;
+            }
+            
+            if (emitted >= limits.maxWidth || overBudget()) {
+                truncated = true;
+                lua_pop(L, 2);
+                break;
+            }
+            
+            emitted++;
+            
+            if (isArray) {
+                w.beginElement(table);
+                value(-1, depth + 1);
+                w.endElement(table);
+            } else {
+                w.key(table, tableKeyString(L, -2));
+                value(-1, depth + 1);
+            }
+            
+            lua_pop(L, 1);
+        }
+        
+        w.endEntries(table, isArray);
+        if (truncated) {
+            w.truncation(table, retainInspectHandle(L, idx), offset + emitted);
+        }
+        if (depth == 0 && captureToString) appendToString(idx, table);
+        w.end(table);
+        
+        ancestors.erase(ptr);
+    }
+    
+private:
+    lua_State* L;
+    Writer w;
+    SerializeLimits limits;
+    size_t startSize;
+    bool captureToString = false;   // set while serializing a top-level print argument
+    std::unordered_set<const void*> ancestors;
+    
+    bool overBudget() const {
+        return w.out.size() - startSize > limits.maxBytes;
+    }
+    
+    // Runs __tostring at most once per printed value (errors propagate, as print always did)
+    void appendToString(int idx, typename Writer::Object& object) {
+        if (!luaL_getmetafield(L, idx, "__tostring")) return;
+        lua_pop(L, 1);
+        
+        size_t len;
+        const char* s = luaL_tolstring(L, idx, &len);
+        capturedToString = std::string(s, len);
+        lua_pop(L, 1);
+        
+        w.toString(object, *capturedToString);
+    }
+};
+
+// Print records of the current run, JSON arrays or binary values (g_resultEncoding)
+static std::vector<std::string> g_printCalls;
+// Time spent serializing printed values in the current run (measured while tracing)
+static double g_serializeMs = 0.0;
+// Set while benchmarking; printed values are dropped without being serialized
+static bool g_discardPrints = false;
+
+static std::string buildPrintsJson() {
+    std::string prints = "[";
+    for (size_t i = 0; i < g_printCalls.size(); i++) {
+        if (i > 0) prints += ",";
+        prints += g_printCalls[i];
+    }
+    prints += "]";
+    return prints;
+}
+
+// ============================================================================
+// Print Streaming
+// ============================================================================
+
+// In streaming mode g_printCalls is a bounded buffer drained to the host while the
+// script runs; otherwise it collects every record until luau_execute returns.
+struct PrintStreamConfig {
+    bool enabled = false;
+    double flushIntervalMs = 50.0;          // max age of buffered records
+    size_t flushBytes = 64 * 1024;          // buffered bytes that force a flush
+    size_t maxOutputBytes = 16 * 1024 * 1024; // streamed records past this are dropped (0 = unlimited)
+};
+
+struct PrintStreamStats {
+    uint32_t flushes = 0;
+    uint32_t flushedRecords = 0;
+    size_t totalBytes = 0;
+    uint32_t dropped = 0;
+    double firstFlushMs = -1.0;             // time from run start to first flush
+};
+
+static PrintStreamConfig g_printStream;
+// Build the luaL_tolstring plain text view (luau_execute "output") alongside the records;
+// hosts that render from the records turn this off
+static bool g_printText = true;
+static PrintStreamStats g_printStats;
+static size_t g_pendingPrintBytes = 0;
+static double g_runStartMs = 0.0;
+static double g_lastPrintFlushMs = 0.0;
+// Binary batch handed to the host, reused across flushes
+static std::string g_printBatchBuffer;
+
+#ifdef __EMSCRIPTEN__
+// Delivers print records to the host: a JSON array (Module.onPrintBatch), or with the
+// binary encoding a PrintBatch result valid for the duration of the call (Module.onPrintBatchBinary)
+EM_JS(void, playground_emit_prints, (const char* data, int length, bool binary), {
+    if (binary) {
+        var binaryHandler = Module['onPrintBatchBinary'];
+        if (binaryHandler) binaryHandler(data, length);
+    } else {
+        var handler = Module['onPrintBatch'];
+        if (handler) handler(UTF8ToString(data, length));
+    }
+});
+#else
+static void playground_emit_prints(const char* data, int length, bool binary) {
+    // No host to deliver to outside the browser
+}
+#endif
+
+static void resetPrintStream() {
+    g_printStats = PrintStreamStats{};
+    g_pendingPrintBytes = 0;
+    g_runStartMs = nowMs();
+    g_lastPrintFlushMs = g_runStartMs;
+}
+
+static void flushPrints() {
+    if (g_printCalls.empty()) return;
+    
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        BinaryResultWriter writer(BinaryResultKind::PrintBatch);
+        for (const std::string& record : g_printCalls) {
+            writer.beginRecord();
+            writer.bytes(record);
+            writer.endRecord();
+        }
+        
+        writer.finishInto(g_printBatchBuffer);
+        playground_emit_prints(g_printBatchBuffer.data(), static_cast<int>(g_printBatchBuffer.size()), true);
+    } else {
+        std::string batch = buildPrintsJson();
+        playground_emit_prints(batch.c_str(), static_cast<int>(batch.size()), false);
+    }
+    
+    double now = nowMs();
+    if (g_printStats.flushes == 0) g_printStats.firstFlushMs = now - g_runStartMs;
+    g_printStats.flushes++;
+    g_printStats.flushedRecords += static_cast<uint32_t>(g_printCalls.size());
+    
+    g_printCalls.clear();
+    g_pendingPrintBytes = 0;
+    g_lastPrintFlushMs = now;
+}
+
+static void flushPrintsIfDue(double now) {
+    if (g_printStream.enabled && !g_printCalls.empty() &&
+        now - g_lastPrintFlushMs >= g_printStream.flushIntervalMs) {
+        flushPrints();
+    }
+}
+
+// Serialize the n arguments of a print call into one record, and its tab-separated
+// plain text into `line` if given
+template<typename Writer>
+static void serializePrintArgs(lua_State* L, int n, std::string& record, std::string* line) {
+    ValueSerializer<Writer> serializer(L, record, g_serializeLimits);
+    serializer.beginValues();
+    for (int i = 1; i <= n; i++) {
+        if (i > 1) serializer.separator();
+        serializer.value(i);
+        
+        if (line) {
+            if (i > 1) *line += "\t";
+            if (serializer.capturedToString) {
+                *line += *serializer.capturedToString;
+            } else {
+                // No metamethod left to run, so this cannot observe the value twice
+                size_t len;
+                const char* s = luaL_tolstring(L, i, &len);
+                if (s) *line += std::string(s, len);
+                lua_pop(L, 1);
+            }
+        }
+    }
+    serializer.endValues();
+}
+
+static int playgroundPrint(lua_State* L) {
+    if (g_discardPrints) return 0;
+    
+    int n = lua_gettop(L);
+    
+    // Past the streaming cap, drop records instead of flooding the host
+    if (g_printStream.enabled && g_printStream.maxOutputBytes &&
+        g_printStats.totalBytes >= g_printStream.maxOutputBytes) {
+        g_printStats.dropped++;
+        return 0;
+    }
+    
+    // Plain text is only needed when the host does not render from the records
+    bool buildText = g_printText && !g_printStream.enabled;
+    std::string line;
+    
+    double serializeStart = g_trace.enabled ? nowMs() : 0.0;
+    
+    std::string record;
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        serializePrintArgs<BinaryValueWriter>(L, n, record, buildText ? &line : nullptr);
+    } else {
+        serializePrintArgs<JsonValueWriter>(L, n, record, buildText ? &line : nullptr);
+    }
+    
+    if (g_trace.enabled) {
+        g_serializeMs += nowMs() - serializeStart;
+    }
+    
+    g_printStats.totalBytes += record.size();
+    g_pendingPrintBytes += record.size();
+    g_printCalls.push_back(std::move(record));
+    
+    if (g_printStream.enabled) {
+        // A full buffer is drained synchronously, which throttles the script to the host
+        if (g_pendingPrintBytes >= g_printStream.flushBytes) {
+            flushPrints();
+        } else {
+            flushPrintsIfDue(nowMs());
+        }
+        return 0;
+    }
+    
+    if (buildText) {
+        if (!g_outputBuffer.empty()) {
+            g_outputBuffer += "\n";
+        }
+        g_outputBuffer += line;
+    }
+    
+    return 0;
+}
+
+// Values returned by modules required during the current run (registry refs), like package.loaded
+static std::unordered_map<std::string, int> g_loadedModules;
+
+static void clearLoadedModules(lua_State* L) {
+    for (const auto& [_, ref] : g_loadedModules) {
+        lua_unref(L, ref);
+    }
+    g_loadedModules.clear();
+}
+
+// Custom require function that loads from g_moduleRegistry
+static int playgroundRequire(lua_State* L) {
+    const char* moduleName = luaL_checkstring(L, 1);
+    
+    const ModuleRegistry::Entry* module = g_moduleRegistry.find(moduleName);
+    
+    if (!module) {
+        // List available modules for debugging
+        std::string available;
+        for (const auto& [name, _] : g_moduleRegistry.all()) {
+            if (!available.empty()) available += ", ";
+            available += "'" + name + "'";
+        }
+        luaL_error(L, "module '%s' not found\navailable modules: %s", moduleName, available.c_str());
+        return 0;
+    }
+    
+    // Repeated requires within a run return the same value
+    auto loaded = g_loadedModules.find(module->first);
+    if (loaded != g_loadedModules.end()) {
+        lua_getref(L, loaded->second);
+        return 1;
+    }
+    
+    const std::string& bytecode = compileCached(module->second.source, executionCompileOptions());
+    
+    // Load and execute the module
+    std::string chunkName = std::string("=") + moduleName;
+    int loadResult = luau_load(L, chunkName.c_str(), bytecode.data(), bytecode.size(), 0);
+    
+    if (loadResult != 0) {
+        lua_error(L);
+        return 0;
+    }
+    
+    trackCoverageChunk(L, module->first);
+    
+    // Execute the module; scripts can't change the registry, so module stays valid
+    lua_call(L, 0, 1);
+    
+    if (!lua_isnil(L, -1)) {
+        g_loadedModules[module->first] = lua_ref(L, -1);
+    }
+    
+    return 1;
+}
+
+// Error handler that generates stack traces
+static int errorHandler(lua_State* L) {
+    // Get the error message
+    std::string errorMsg;
+    
+    if (lua_isstring(L, 1)) {
+        const char* msg = lua_tostring(L, 1);
+        errorMsg = msg ? msg : "unknown error";
+    } else {
+        // Try to convert to string
+        const char* typeName = lua_typename(L, lua_type(L, 1));
+        errorMsg = std::string("(error object is a ") + typeName + " value)";
+    }
+    
+    // Build stack trace manually since Luau doesn't have luaL_traceback
+    std::string trace = errorMsg;
+    trace += "\nstack traceback:";
+    
+    lua_Debug ar;
+    int level = 1;
+    while (lua_getinfo(L, level, "sln", &ar)) {
+        trace += "\n\t";
+        if (ar.source) {
+            trace += ar.source;
+        }
+        if (ar.currentline > 0) {
+            trace += ":";
+            trace += std::to_string(ar.currentline);
+        }
+        if (ar.name) {
+            trace += " in function '";
+            trace += ar.name;
+            trace += "'";
+        } else if (ar.what && strcmp(ar.what, "main") == 0) {
+            trace += " in main chunk";
+        } else if (ar.what && strcmp(ar.what, "C") == 0) {
+            trace += " in C function";
+        } else {
+            trace += " in ?";
+        }
+        level++;
+    }
+    
+    lua_pushstring(L, trace.c_str());
+    return 1;
+}
+
+// ============================================================================
+// Sampling Profiler (VM interrupt)
+// ============================================================================
+
+// Safepoints between profiler clock reads; a clock read per safepoint would skew tight loops
+static const uint32_t kProfileCheckInterval = 16;
+// Frames captured per sample; deeper stacks keep their innermost frames
+static const int kProfileMaxDepth = 64;
+static const int kProfileMinIntervalUs = 100;
+
+struct ProfilerConfig {
+    bool enabled = false;
+    double intervalMs = 1.0;
+};
+
+struct ProfileFunction {
+    std::string name;
+    std::string source;
+    int line = 0;
+    uint32_t self = 0;   // samples with this function on top
+    uint32_t total = 0;  // samples with this function anywhere on the stack
+};
+
+struct ProfileData {
+    bool active = false;
+    uint32_t countdown = kProfileCheckInterval;
+    double startMs = 0.0;
+    double nextSampleMs = 0.0;
+    uint32_t samples = 0;
+    uint32_t truncated = 0;
+    std::unordered_map<std::string, uint32_t> stacks; // collapsed "root;...;leaf" -> samples
+    std::unordered_map<std::string, ProfileFunction> functions;
+    std::map<std::string, std::map<int, uint32_t>> lines; // source -> line -> self samples
+};
+
+static ProfilerConfig g_profiler;
+static ProfileData g_profile;
+
+static void resetProfile() {
+    g_profile = ProfileData{};
+    g_profile.active = g_profiler.enabled;
+    g_profile.startMs = nowMs();
+    g_profile.nextSampleMs = g_profile.startMs + g_profiler.intervalMs;
+}
+
+// Capture the running thread's stack; only frames of the thread that hit the safepoint are visible
+static void sampleProfile(lua_State* L) {
+    struct Frame {
+        std::string key;
+        std::string label;
+    };
+
+    std::vector<Frame> frames;
     lua_Debug ar;
-    int level = 1;
-    while (lua_getinfo(L, level, "sln", &ar)) {
-        trace += "\n\t";
-        if (ar.source) {
-            trace += ar.source;
+    int level = 0;
+    for (; level < kProfileMaxDepth && lua_getinfo(L, level, "sln", &ar); level++) {
+        bool isC = ar.what && strcmp(ar.what, "C") == 0;
+        bool isMain = ar.what && strcmp(ar.what, "main") == 0;
+        std::string source = ar.short_src ? ar.short_src : "?";
+        std::string name = ar.name ? ar.name : isMain ? "main chunk" : "anonymous";
+
+        Frame frame;
+        frame.key = name + "@" + source + ":" + std::to_string(ar.linedefined);
+        frame.label = isC ? name + " [C]" : name + " (" + source + ":" + std::to_string(ar.linedefined) + ")";
+
+        ProfileFunction& fn = g_profile.functions[frame.key];
+        if (fn.total == 0 && fn.self == 0) {
+            fn.name = name;
+            fn.source = source;
+            fn.line = ar.linedefined;
+        }
+        if (level == 0) {
+            fn.self++;
+            if (!isC && ar.currentline > 0) {
+                g_profile.lines[source][ar.currentline]++;
+            }
+        }
+
+        // Recursive functions count once per sample towards their total
+        bool seen = false;
+        for (const Frame& other : frames) {
+            if (other.key == frame.key) {
+                seen = true;
+                break;
+            }
+        }
+        if (!seen) fn.total++;
+
+        frames.push_back(std::move(frame));
+    }
+
+    if (frames.empty()) return;
+
+    std::string stack;
+    if (lua_getinfo(L, level, "", &ar)) {
+        g_profile.truncated++;
+        stack = "(truncated)";
+    }
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if (!stack.empty()) stack += ";";
+        stack += it->label;
+    }
+
+    g_profile.stacks[stack]++;
+    g_profile.samples++;
+}
+
+// Called on every safepoint while a profiled run is active
+static void profileSafepoint(lua_State* L) {
+    if (--g_profile.countdown != 0) return;
+    g_profile.countdown = kProfileCheckInterval;
+
+    double now = nowMs();
+    if (now < g_profile.nextSampleMs) return;
+
+    sampleProfile(L);
+    g_profile.nextSampleMs = now + g_profiler.intervalMs;
+}
+
+// { intervalMs, durationMs, samples, truncated, stacks: [{ stack, count }], functions: [...],
+//   lines: { source: [[line, count], ...] } }; stacks and functions are sorted hottest first
+static std::string buildProfileJson() {
+    std::vector<std::pair<const std::string*, uint32_t>> stacks;
+    stacks.reserve(g_profile.stacks.size());
+    for (const auto& [stack, count] : g_profile.stacks) {
+        stacks.emplace_back(&stack, count);
+    }
+    std::sort(stacks.begin(), stacks.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : *a.first < *b.first;
+    });
+
+    std::vector<const ProfileFunction*> functions;
+    functions.reserve(g_profile.functions.size());
+    for (const auto& [_, fn] : g_profile.functions) {
+        functions.push_back(&fn);
+    }
+    std::sort(functions.begin(), functions.end(), [](const ProfileFunction* a, const ProfileFunction* b) {
+        if (a->total != b->total) return a->total > b->total;
+        if (a->self != b->self) return a->self > b->self;
+        return a->source != b->source ? a->source < b->source : a->line < b->line;
+    });
+
+    std::ostringstream out;
+    out << "{\"intervalMs\":" << g_profiler.intervalMs;
+    out << ",\"durationMs\":" << (nowMs() - g_profile.startMs);
+    out << ",\"samples\":" << g_profile.samples;
+    out << ",\"truncated\":" << g_profile.truncated;
+
+    out << ",\"stacks\":[";
+    for (size_t i = 0; i < stacks.size(); i++) {
+        if (i > 0) out << ",";
+        out << "{\"stack\":" << json::string(*stacks[i].first) << ",\"count\":" << stacks[i].second << "}";
+    }
+    out << "]";
+
+    out << ",\"functions\":[";
+    for (size_t i = 0; i < functions.size(); i++) {
+        const ProfileFunction& fn = *functions[i];
+        if (i > 0) out << ",";
+        out << "{\"name\":" << json::string(fn.name);
+        out << ",\"source\":" << json::string(fn.source);
+        out << ",\"line\":" << fn.line;
+        out << ",\"self\":" << fn.self;
+        out << ",\"total\":" << fn.total << "}";
+    }
+    out << "]";
+
+    out << ",\"lines\":{";
+    bool firstSource = true;
+    for (const auto& [source, counts] : g_profile.lines) {
+        if (!firstSource) out << ",";
+        firstSource = false;
+        out << json::string(source) << ":[";
+        bool firstLine = true;
+        for (const auto& [line, count] : counts) {
+            if (!firstLine) out << ",";
+            firstLine = false;
+            out << "[" << line << "," << count << "]";
+        }
+        out << "]";
+    }
+    out << "}}";
+
+    return out.str();
+}
+
+/**
+ * Configure the sampling profiler for subsequent runs.
+ * @param enabled Sample the Luau call stack from the VM interrupt while luau_execute runs
+ * @param intervalUs Minimum time between samples in microseconds (clamped to 100us)
+ */
+EXPORT void luau_set_profiling(bool enabled, int intervalUs) {
+    g_profiler.enabled = enabled;
+    g_profiler.intervalMs = std::max(kProfileMinIntervalUs, intervalUs) / 1000.0;
+}
+
+// ============================================================================
+// Execution Allocator
+// ============================================================================
+
+// Luau already carves small objects out of size-class pages (lmem.cpp), so the requests
+// seen here are mostly those pages plus large arrays and strings. Freed blocks up to
+// kPoolMaxBlock stay in per-class free lists and are handed to later runs instead of
+// going back to malloc, whose memory is never returned to the worker anyway.
+static const size_t kPoolGranularity = 16;
+static const size_t kPoolSmallLimit = 1024;         // 16-byte classes up to here, then powers of two
+static const size_t kPoolMaxBlock = 64 * 1024;
+static const size_t kPoolClassCount = kPoolSmallLimit / kPoolGranularity + 6; // 2K..64K
+static const size_t kPoolMaxRetainedBytes = 8 * 1024 * 1024;
+// Allocations still allowed past the cap so the error can be raised and reported
+static const size_t kMemoryLimitSlack = 1024 * 1024;
+// Growth over the previous run's baseline that triggers a full collection before the next run
+static const size_t kCollectBetweenRunsBytes = 4 * 1024 * 1024;
+
+class ExecutionAllocator {
+public:
+    // Per-run counters (reset by beginRun)
+    size_t limitBytes = 0;       // growth allowed over the baseline, 0 = unlimited
+    size_t baselineBytes = 0;
+    size_t peakBytes = 0;
+    uint32_t allocations = 0;
+    uint64_t allocatedBytes = 0; // new blocks and growth, regardless of later frees
+    uint32_t gcCycles = 0;
+    bool limitHit = false;
+    
+    size_t liveBytes = 0;
+    
+    ~ExecutionAllocator() {
+        trim();
+    }
+    
+    void beginRun() {
+        baselineBytes = liveBytes;
+        peakBytes = liveBytes;
+        allocations = 0;
+        allocatedBytes = 0;
+        gcCycles = 0;
+        limitHit = false;
+    }
+    
+    // Release pooled blocks; called once the state using them is closed
+    void trim() {
+        for (std::vector<void*>& list : freeLists) {
+            for (void* block : list) free(block);
+            list.clear();
+        }
+        retainedBytes = 0;
+    }
+    
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+        ExecutionAllocator& self = *static_cast<ExecutionAllocator*>(ud);
+        size_t oldSize = ptr ? osize : 0;
+        
+        if (nsize == 0) {
+            if (ptr) self.release(ptr, osize);
+            self.liveBytes -= oldSize;
+            return nullptr;
+        }
+        
+        if (nsize > oldSize && !self.admit(nsize - oldSize)) {
+            return nullptr;
+        }
+        
+        void* block = nullptr;
+        if (ptr && sizeClass(osize) == sizeClass(nsize) && sizeClass(nsize) < kPoolClassCount) {
+            block = ptr;
+        } else if (ptr && osize > kPoolMaxBlock && nsize > kPoolMaxBlock) {
+            block = realloc(ptr, nsize);
+            if (!block) return nullptr;
+        } else {
+            block = self.acquire(nsize);
+            if (!block) return nullptr;
+            if (ptr) {
+                memcpy(block, ptr, std::min(osize, nsize));
+                self.release(ptr, osize);
+            }
+        }
+        
+        if (!ptr) self.allocations++;
+        if (nsize > oldSize) self.allocatedBytes += nsize - oldSize;
+        self.liveBytes = self.liveBytes - oldSize + nsize;
+        self.peakBytes = std::max(self.peakBytes, self.liveBytes);
+        return block;
+    }
+    
+private:
+    std::vector<void*> freeLists[kPoolClassCount];
+    size_t retainedBytes = 0;
+    
+    // Index of the pool class serving a size; kPoolClassCount for unpooled sizes
+    static size_t sizeClass(size_t size) {
+        if (size <= kPoolSmallLimit) {
+            return (size + kPoolGranularity - 1) / kPoolGranularity - 1;
+        }
+        if (size > kPoolMaxBlock) return kPoolClassCount;
+        
+        size_t index = kPoolSmallLimit / kPoolGranularity;
+        for (size_t classSize = kPoolSmallLimit * 2; classSize < size; classSize *= 2) index++;
+        return index;
+    }
+    
+    static size_t classSize(size_t index) {
+        size_t smallClasses = kPoolSmallLimit / kPoolGranularity;
+        if (index < smallClasses) return (index + 1) * kPoolGranularity;
+        return kPoolSmallLimit << (index - smallClasses + 1);
+    }
+    
+    bool admit(size_t growth) {
+        if (limitBytes == 0) return true;
+        
+        size_t cap = baselineBytes + limitBytes + (limitHit ? kMemoryLimitSlack : 0);
+        if (liveBytes + growth <= cap) return true;
+        
+        limitHit = true;
+        return false;
+    }
+    
+    void* acquire(size_t size) {
+        size_t index = sizeClass(size);
+        if (index >= kPoolClassCount) return malloc(size);
+        
+        std::vector<void*>& list = freeLists[index];
+        if (!list.empty()) {
+            void* block = list.back();
+            list.pop_back();
+            retainedBytes -= classSize(index);
+            return block;
+        }
+        return malloc(classSize(index));
+    }
+    
+    void release(void* block, size_t size) {
+        size_t index = sizeClass(size);
+        if (index < kPoolClassCount && retainedBytes + classSize(index) <= kPoolMaxRetainedBytes) {
+            freeLists[index].push_back(block);
+            retainedBytes += classSize(index);
+        } else {
+            free(block);
+        }
+    }
+};
+
+// Declared before the base state so it outlives it
+static ExecutionAllocator g_allocator;
+
+/**
+ * Cap the memory a single luau_execute may allocate on top of the template state.
+ * Past the cap allocations fail and the run ends with an out of memory error.
+ * @param limitBytes Bytes per run (0 = unlimited)
+ */
+EXPORT void luau_set_memory_limit(int limitBytes) {
+    g_allocator.limitBytes = static_cast<size_t>(std::max(0, limitBytes));
+}
+
+// ============================================================================
+// Execution Budget (VM interrupt)
+// ============================================================================
+
+// Safepoints between clock/flag polls; polling on every safepoint would dominate tight loops
+static const uint32_t kInterruptPollInterval = 1024;
+
+struct ExecutionBudget {
+    double deadline = 0.0;            // wall-clock deadline in ms, 0 = unlimited
+    uint32_t safepointLimit = 0;      // max VM safepoints, 0 = unlimited
+    uint32_t safepoints = 0;
+    bool pollStop = true;             // false when the host's stop flag may still be set from a run
+    const char* interruptReason = nullptr;
+};
+
+static ExecutionBudget g_budget;
+
+#ifdef __EMSCRIPTEN__
+// Reads the stop flag that the host shares with this worker (Int32Array over a SharedArrayBuffer)
+EM_JS(int, playground_poll_interrupt, (), {
+    var flag = Module['playgroundInterrupt'];
+    return flag ? Atomics.load(flag, 0) : 0;
+});
+#else
+static int playground_poll_interrupt() {
+    return 0;
+}
+#endif
+
+static void playgroundInterrupt(lua_State* L, int gc) {
+    // GC steps are reported with gc >= 0 (the collector state at the start of the step)
+    // and are not safe to raise errors from. A step leaving GCSpause (0) begins a cycle.
+    if (gc >= 0) {
+        if (gc == 0) g_allocator.gcCycles++;
+        return;
+    }
+    
+    if (g_profile.active && !g_budget.interruptReason) {
+        profileSafepoint(L);
+    }
+    
+    // Once interrupted, keep raising so a script can't swallow the error with pcall
+    if (!g_budget.interruptReason) {
+        g_budget.safepoints++;
+        
+        if (g_allocator.limitHit) {
+            g_budget.interruptReason = "memory limit exceeded";
+        } else if (g_budget.safepointLimit && g_budget.safepoints > g_budget.safepointLimit) {
+            g_budget.interruptReason = "instruction budget exceeded";
+        } else if (g_budget.safepoints % kInterruptPollInterval != 0) {
+            return;
+        } else {
+            double now = nowMs();
+            
+            // Scripts that print once and then compute still get their output delivered
+            flushPrintsIfDue(now);
+            
+            if (g_budget.pollStop && playground_poll_interrupt()) {
+                g_budget.interruptReason = "stopped by user";
+            } else if (g_budget.deadline > 0.0 && now > g_budget.deadline) {
+                g_budget.interruptReason = "time limit exceeded";
+            } else {
+                return;
+            }
+        }
+    }
+    
+    luaL_error(L, "execution interrupted: %s", g_budget.interruptReason);
+}
+
+// Register sandbox globals
+static void registerPlaygroundGlobals(lua_State* L) {
+    // Open standard libraries FIRST
+    luaL_openlibs(L);
+    
+    // THEN override print with our custom version that captures output
+    lua_pushcfunction(L, playgroundPrint, "print");
+    lua_setglobal(L, "print");
+    
+    // Override require with our custom version
+    lua_pushcfunction(L, playgroundRequire, "require");
+    lua_setglobal(L, "require");
+}
+
+// Sandboxed template state, built once and shared by every run.
+// Each luau_execute gets its own thread with isolated globals (luaL_sandboxthread),
+// so library setup is paid only on the first run or after luau_reset.
+static std::unique_ptr<lua_State, decltype(&lua_close)> g_baseState(nullptr, lua_close);
+
+static lua_State* ensureBaseState() {
+    if (!g_baseState) {
+        g_baseState.reset(lua_newstate(ExecutionAllocator::alloc, &g_allocator));
+        if (!g_baseState) return nullptr;
+        
+        registerPlaygroundGlobals(g_baseState.get());
+        lua_callbacks(g_baseState.get())->interrupt = playgroundInterrupt;
+        
+        // Freeze libraries and the global table; per-run writes go to the thread's globals
+        luaL_sandbox(g_baseState.get());
+    }
+    return g_baseState.get();
+}
+
+// Keeps a run thread anchored on the base state's stack and releases it on scope exit
+struct RunThread {
+    lua_State* base;
+    int baseTop;
+    lua_State* L;
+    
+    explicit RunThread(lua_State* base)
+        : base(base)
+        , baseTop(lua_gettop(base))
+        , L(lua_newthread(base))
+    {
+        luaL_sandboxthread(L);
+    }
+    
+    ~RunThread() {
+        clearLoadedModules(base);
+        lua_settop(base, baseTop);
+    }
+    
+    RunThread(const RunThread&) = delete;
+    RunThread& operator=(const RunThread&) = delete;
+};
+
+#ifndef LUAU_PLAYGROUND_EXECUTION_ONLY
+// Codegen output for the function at the top of L's stack (a loaded chunk)
+static std::string getCodegenAssembly(
+    lua_State* L,
+    Luau::CodeGen::AssemblyOptions options,
+    Luau::CodeGen::LoweringStats* stats
+) {
+    return Luau::CodeGen::getAssembly(L, -1, options, stats);
+}
+
+static void annotateInstruction(void* context, std::string& text, int fid, int instpos)
+{
+    Luau::BytecodeBuilder& bcb = *(Luau::BytecodeBuilder*)context;
+
+    bcb.annotateInstruction(text, fid, instpos);
+}
+#endif
+
+/**
+ * Add a module that can be required.
+ * Call this before luau_execute to set up modules.
+ */
+EXPORT void luau_add_module(const char* name, const char* source) {
+    g_moduleRegistry.insert(name).second.source = source;
+}
+
+/**
+ * Clear all modules.
+ */
+EXPORT void luau_clear_modules() {
+    g_moduleRegistry.clear();
+}
+
+/**
+ * Rebuild the cached execution template state.
+ * The next luau_execute starts from freshly opened libraries.
+ */
+EXPORT void luau_reset() {
+    // Handle and coverage refs die with the state
+    g_inspectRefs.clear();
+    g_inspectHandles.clear();
+    releaseCoverageChunks(nullptr);
+    g_baseState.reset();
+    g_allocator.trim();
+    g_outputBuffer.clear();
+    g_printCalls.clear();
+}
+
+/**
+ * Get list of available modules for autocomplete.
+ * Returns: { "modules": ["name1", "name2", ...] }
+ */
+EXPORT const char* luau_get_modules() {
+    std::ostringstream json;
+    json << "{\"modules\":[";
+    
+    bool first = true;
+    auto add = [&](const std::string& name) {
+        if (!first) json << ",";
+        first = false;
+        json << ::json::string(name);
+    };
+    
+    for (const auto& [name, _] : g_moduleRegistry.all()) {
+        // Skip the main file
+        if (name == "main" || name == "main.luau") continue;
+        add(name);
+        
+        // Offer the short name require also resolves, unless it is a module of its own
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos) continue;
+        
+        std::string extension = name.substr(dot);
+        std::string shortName = name.substr(0, dot);
+        if ((extension == ".luau" || extension == ".lua") && shortName != "main" && !g_moduleRegistry.findExact(shortName)) {
+            add(shortName);
+        }
+    }
+    
+    json << "]}";
+    return setResult(json.str());
+}
+
+/**
+ * Configure print delivery for subsequent runs.
+ * @param enabled Stream print records to Module.onPrintBatch while the script runs
+ * @param flushIntervalMs Max time a record stays buffered before it is delivered
+ * @param flushBytes Buffered bytes that force a synchronous flush (backpressure)
+ * @param maxOutputBytes Total record bytes per streaming run; later prints are dropped (0 = unlimited).
+ *                       Runs without streaming keep every record
+ */
+EXPORT void luau_set_print_streaming(bool enabled, int flushIntervalMs, int flushBytes, int maxOutputBytes) {
+    g_printStream.enabled = enabled;
+    g_printStream.flushIntervalMs = std::max(0, flushIntervalMs);
+    g_printStream.flushBytes = static_cast<size_t>(std::max(1, flushBytes));
+    g_printStream.maxOutputBytes = static_cast<size_t>(std::max(0, maxOutputBytes));
+}
+
+/**
+ * Choose whether luau_execute also returns the plain text "output".
+ * When disabled only the structured print records are produced; __tostring results
+ * are still captured on them ("tostring") so the text can be rendered by the host.
+ */
+EXPORT void luau_set_print_text(bool enabled) {
+    g_printText = enabled;
+}
+
+// Binary form of the luau_execute result.
+// Record 0: u8 success, u8 interrupted, u32 droppedPrints, str output, str error,
+//           u8 streamed, u32 flushes, u32 records, u32 bytes, i32 firstFlushMs, str profile (JSON),
+//           str coverage (JSON), u32 memoryLimitBytes, u32 peakBytes, u32 allocations, u32 gcCycles,
+//           u8 outOfMemory
+// Records 1..n: the print call's arguments, binary values back to back (BinaryValueWriter)
+static const char* setExecuteResultBinary(bool success, const std::string& error) {
+    BinaryResultWriter writer(BinaryResultKind::Execute);
+    
+    writer.beginRecord();
+    writer.u8(success ? 1 : 0);
+    writer.u8(g_budget.interruptReason ? 1 : 0);
+    writer.u32(g_printStats.dropped);
+    writer.str(g_outputBuffer);
+    if (success) {
+        writer.noString();
+    } else {
+        writer.str(error);
+    }
+    writer.u8(g_printStream.enabled ? 1 : 0);
+    writer.u32(static_cast<uint32_t>(g_printStats.flushes));
+    writer.u32(static_cast<uint32_t>(g_printStats.flushedRecords));
+    writer.u32(static_cast<uint32_t>(g_printStats.totalBytes));
+    writer.i32(static_cast<int32_t>(g_printStats.firstFlushMs));
+    if (g_profile.active) {
+        writer.str(buildProfileJson());
+    } else {
+        writer.noString();
+    }
+    if (!g_coverageJson.empty()) {
+        writer.str(g_coverageJson);
+    } else {
+        writer.noString();
+    }
+    writer.u32(static_cast<uint32_t>(g_allocator.limitBytes));
+    writer.u32(static_cast<uint32_t>(g_allocator.peakBytes - g_allocator.baselineBytes));
+    writer.u32(g_allocator.allocations);
+    writer.u32(g_allocator.gcCycles);
+    writer.u8(g_allocator.limitHit ? 1 : 0);
+    writer.endRecord();
+    
+    for (const std::string& record : g_printCalls) {
+        writer.beginRecord();
+        writer.bytes(record);
+        writer.endRecord();
+    }
+    
+    return writer.finish();
+}
+
+// Build the luau_execute result; in streaming mode remaining records are flushed first
+static const char* setExecuteResult(bool success, const std::string& error = std::string()) {
+    if (g_printStream.enabled) {
+        flushPrints();
+    }
+    
+    TraceSpan span("buildResult", "execute");
+    
+    // Later interrupts (value inspection) are not part of the profiled run
+    struct ProfileEnd {
+        ~ProfileEnd() { g_profile.active = false; }
+    } profileEnd;
+    
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        return setExecuteResultBinary(success, error);
+    }
+    
+    std::ostringstream result;
+    result << "{\"success\":" << json::boolean(success);
+    result << ",\"output\":" << json::string(g_outputBuffer);
+    result << ",\"prints\":" << buildPrintsJson();
+    
+    if (!success) {
+        result << ",\"error\":" << json::string(error);
+    }
+    if (g_budget.interruptReason) {
+        result << ",\"interrupted\":true";
+    }
+    if (g_printStats.dropped > 0) {
+        result << ",\"droppedPrints\":" << g_printStats.dropped;
+    }
+    if (g_printStream.enabled) {
+        result << ",\"stream\":{";
+        result << "\"flushes\":" << g_printStats.flushes;
+        result << ",\"records\":" << g_printStats.flushedRecords;
+        result << ",\"bytes\":" << g_printStats.totalBytes;
+        result << ",\"firstFlushMs\":" << g_printStats.firstFlushMs;
+        result << "}";
+    }
+    if (g_profile.active) {
+        result << ",\"profile\":" << buildProfileJson();
+    }
+    if (!g_coverageJson.empty()) {
+        result << ",\"coverage\":" << g_coverageJson;
+    }
+    
+    // Peak is measured over the template state the run started from
+    result << ",\"memory\":{";
+    result << "\"limitBytes\":" << g_allocator.limitBytes;
+    result << ",\"peakBytes\":" << (g_allocator.peakBytes - g_allocator.baselineBytes);
+    result << ",\"allocations\":" << g_allocator.allocations;
+    result << ",\"gcCycles\":" << g_allocator.gcCycles;
+    if (g_allocator.limitHit) {
+        result << ",\"outOfMemory\":true";
+    }
+    result << "}";
+    
+    result << "}";
+    return setResult(result.str());
+}
+
+/**
+ * Execute Luau code and return the output as JSON.
+ * @param code The Luau source code
+ * @param timeLimitMs Wall-clock budget in milliseconds (0 = unlimited)
+ * @param safepointLimit VM safepoint budget (loop back edges, calls; 0 = unlimited)
+ * Returns: { "success": bool, "output": string, "prints": [[LuauValue]], "error": string?, "interrupted": bool?,
+ *            "droppedPrints": number?, "stream": { flushes, records, bytes, firstFlushMs }?,
+ *            "profile": { intervalMs, durationMs, samples, truncated, stacks, functions, lines }?,
+ *            "coverage": { level, files: { [chunk]: { lines, covered, total } } }?,
+ *            "memory": { limitBytes, peakBytes, allocations, gcCycles, outOfMemory? } }
+ */
+EXPORT const char* luau_execute(const char* code, int timeLimitMs, int safepointLimit) {
+    TraceSpan span("luau_execute", "execute");
+    
+    g_outputBuffer.clear();
+    g_printCalls.clear();
+    g_serializeMs = 0.0;
+    g_coverageJson.clear();
+    resetPrintStream();
+    
+    g_budget = ExecutionBudget{};
+    g_budget.deadline = timeLimitMs > 0 ? nowMs() + timeLimitMs : 0.0;
+    g_budget.safepointLimit = safepointLimit > 0 ? static_cast<uint32_t>(safepointLimit) : 0;
+    
+    // Run on a fresh sandboxed thread of the cached template state
+    lua_State* base = ensureBaseState();
+    if (!base) {
+        return setResult("{\"success\":false,\"output\":\"\",\"prints\":[],\"error\":\"Failed to create Lua state\"}");
+    }
+    
+    // Values retained for inspection and uncollected coverage chunks belong to the previous run
+    releaseInspectHandles(base);
+    releaseCoverageChunks(base);
+    
+    // Coverage applies to this run only, including its requires
+    struct CoverageRun {
+        CoverageRun() { g_coverageRun = g_executionCompile.coverageLevel != 0; }
+        ~CoverageRun() { g_coverageRun = false; }
+    } coverageRun;
+    
+    // Reclaim a large previous run up front so its garbage doesn't count against this one
+    if (g_allocator.liveBytes > g_allocator.baselineBytes + kCollectBetweenRunsBytes) {
+        lua_gc(base, LUA_GCCOLLECT, 0);
+    }
+    g_allocator.beginRun();
+    
+    RunThread thread(base);
+    lua_State* L = thread.L;
+    
+    // Push error handler FIRST (so it's at a fixed position)
+    lua_pushcfunction(L, errorHandler, "errorHandler");
+    int errHandlerIdx = lua_gettop(L);  // Should be 1
+    
+    // Compile the code (reused from cache when the source is unchanged)
+    const std::string& bytecode = compileCached(code, executionCompileOptions());
+    
+    // Load the bytecode (function goes on top of error handler)
+    int loadResult = [&] {
+        TraceSpan loadSpan("load", "execute");
+        return luau_load(L, "=main", bytecode.data(), bytecode.size(), 0);
+    }();
+    
+    if (loadResult != 0) {
+        const char* errMsg = lua_tostring(L, -1);
+        return setExecuteResult(false, errMsg ? errMsg : "Failed to load bytecode");
+    }
+    
+    trackCoverageChunk(L, "main");
+    
+    // Stack: [errorHandler, function]
+    // Execute with error handler at position 1
+    // Sampling starts with the call, so compile and load time stay out of the profile
+    resetProfile();
+    
+    bool success = false;
+    std::string error;
+    {
+        // Printed values are serialized while the script runs; their share is reported as args
+        TraceSpan runSpan("run", "execute");
+        try {
+            success = lua_pcall(L, 0, 0, errHandlerIdx) == 0;
+            if (!success) {
+                const char* errMsg = lua_tostring(L, -1);
+                error = errMsg ? errMsg : "Unknown runtime error";
+            }
+        } catch (const std::exception& e) {
+            error = std::string("C++ exception: ") + e.what();
+        } catch (...) {
+            error = "Unknown C++ exception";
         }
-        if (ar.currentline > 0) {
-            trace += ":";
-            trace += std::to_string(ar.currentline);
+        runSpan.arg("prints", static_cast<double>(g_printCalls.size()));
+        runSpan.arg("serializeMs", g_serializeMs);
+    }
+    
+    // Reported even if the script caught the allocation failure itself
+    if (g_allocator.limitHit) {
+        success = false;
+        error = "out of memory: the run exceeded the " + std::to_string(g_allocator.limitBytes / (1024 * 1024)) +
+                " MB execution memory limit";
+    }
+    
+    // A failed run still reports how far it got
+    collectCoverage(L);
+    
+    return setExecuteResult(success, error);
+}
+
+/**
+ * Configure the budgets used when serializing printed values.
+ * Tables past a budget are replaced by handles that luau_inspect_value can expand.
+ */
+EXPORT void luau_set_serialize_limits(int maxDepth, int maxWidth, int maxBytes) {
+    g_serializeLimits.maxDepth = std::max(1, maxDepth);
+    g_serializeLimits.maxWidth = std::max(1, maxWidth);
+    g_serializeLimits.maxBytes = static_cast<size_t>(std::max(1024, maxBytes));
+}
+
+// Time budget for metamethods (e.g. __tostring on keys) run while inspecting
+static const int kInspectTimeLimitMs = 1000;
+
+struct InspectRequest {
+    int ref;
+    std::string path;
+    int offset;
+    std::string json;
+};
+
+// Push the child of the table at tableIdx named by a typed path segment:
+// "s:<key>" and "n:<key>" are string and number keys, looked up raw; "i:<n>" is the
+// n-th entry (1-based) in iteration order, for keys of other types.
+static void pushPathChild(lua_State* L, int tableIdx, const std::string& segment) {
+    if (segment.size() < 2 || segment[1] != ':') {
+        luaL_error(L, "path segment '%s' must start with s:, n: or i:", segment.c_str());
+    }
+    
+    const char* key = segment.c_str() + 2;
+    char* end = nullptr;
+    switch (segment[0]) {
+        case 's':
+            lua_pushlstring(L, key, segment.size() - 2);
+            lua_rawget(L, tableIdx);
+            return;
+        case 'n': {
+            double number = strtod(key, &end);
+            if (end == key || *end != 0) luaL_error(L, "path segment '%s' is not a number", segment.c_str());
+            lua_pushnumber(L, number);
+            lua_rawget(L, tableIdx);
+            return;
         }
-        if (ar.name) {
-            trace += " in function '";
-            trace += ar.name;
-            trace += "'";
-        } else if (ar.what && strcmp(ar.what, "main") == 0) {
-            trace += " in main chunk";
-        } else if (ar.what && strcmp(ar.what, "C") == 0) {
-            trace += " in C function";
-        } else {
-            trace += " in ?";
+        case 'i': {
+            long index = strtol(key, &end, 10);
+            if (end == key || *end != 0 || index < 1) luaL_error(L, "path segment '%s' is not an index", segment.c_str());
+            
+            long visited = 0;
+            lua_pushnil(L);
+            while (lua_next(L, tableIdx) != 0) {
+                if (++visited == index) {
+                    lua_remove(L, -2);
+                    return;
+                }
+                lua_pop(L, 1);
+            }
+            luaL_error(L, "table has no entry %ld", index);
         }
-        level++;
+        default:
+            luaL_error(L, "path segment '%s' must start with s:, n: or i:", segment.c_str());
     }
+}
+
+static int inspectValueProtected(lua_State* L) {
+    InspectRequest* request = static_cast<InspectRequest*>(lua_touserdata(L, 1));
+    lua_getref(L, request->ref);
     
-    lua_pushstring(L, trace.c_str());
-    return 1;
+    // Path segments are typed keys separated by \x1f, resolved from the retained table
+    size_t pos = 0;
+    while (pos < request->path.size()) {
+        size_t end = request->path.find('\x1f', pos);
+        if (end == std::string::npos) end = request->path.size();
+        std::string segment = request->path.substr(pos, end - pos);
+        pos = end + 1;
+        
+        int tableIdx = lua_gettop(L);
+        if (!lua_istable(L, tableIdx)) {
+            luaL_error(L, "path segment '%s' does not refer to a table", segment.c_str());
+        }
+        
+        pushPathChild(L, tableIdx, segment);
+        if (lua_isnil(L, -1)) {
+            luaL_error(L, "key '%s' not found", segment.c_str());
+        }
+        lua_replace(L, tableIdx);
+    }
+    
+    ValueSerializer<JsonValueWriter> serializer(L, request->json, g_serializeLimits);
+    if (lua_istable(L, -1)) {
+        serializer.table(-1, 0, request->offset);
+    } else {
+        serializer.value(-1);
+    }
+    return 0;
 }
 
-// Register sandbox globals
-static void registerPlaygroundGlobals(lua_State* L) {
-    // Open standard libraries FIRST
-    luaL_openlibs(L);
+/**
+ * Expand a value that was truncated when printed.
+ * @param handle Handle from a "truncated" marker of the most recent run
+ * @param path Keys to walk from the handle's table, separated by \x1f (empty for the table itself):
+ *             "s:name" and "n:1" for string and number keys, "i:3" for the third entry in iteration order
+ * @param offset Number of leading entries to skip (the marker's offset)
+ * Returns: { "success": bool, "value": LuauValue?, "error": string? }
+ */
+EXPORT const char* luau_inspect_value(int handle, const char* path, int offset) {
+    lua_State* L = g_baseState.get();
+    if (!L || handle < 0 || handle >= static_cast<int>(g_inspectRefs.size())) {
+        return setResult("{\"success\":false,\"error\":\"Unknown value handle\"}");
+    }
     
-    // THEN override print with our custom version that captures output
-    lua_pushcfunction(L, playgroundPrint, "print");
-    lua_setglobal(L, "print");
+    InspectRequest request{g_inspectRefs[handle], path, std::max(0, offset), std::string()};
     
-    // Override require with our custom version
-    lua_pushcfunction(L, playgroundRequire, "require");
-    lua_setglobal(L, "require");
+    // Values of a stopped run or one past the memory limit are still inspectable: the stop
+    // flag stays set until the next run, and the run's limit state is only set aside
+    g_budget = ExecutionBudget{};
+    g_budget.deadline = nowMs() + kInspectTimeLimitMs;
+    g_budget.pollStop = false;
+    bool runLimitHit = g_allocator.limitHit;
+    g_allocator.limitHit = false;
+    
+    int top = lua_gettop(L);
+    lua_pushcfunction(L, inspectValueProtected, "inspect");
+    lua_pushlightuserdata(L, &request);
+    int status = lua_pcall(L, 1, 0, 0);
+    
+    g_allocator.limitHit = runLimitHit;
+    
+    std::string error;
+    if (status != 0) {
+        const char* errMsg = lua_tostring(L, -1);
+        error = errMsg ? errMsg : "Failed to inspect value";
+    }
+    lua_settop(L, top);
+    
+    if (status != 0) {
+        return setResult("{\"success\":false,\"error\":" + json::string(error) + "}");
+    }
+    return setResult("{\"success\":true,\"value\":" + request.json + "}");
 }
 
-static std::string getCodegenAssembly(
-    const char* name,
-    const std::string& bytecode,
-    Luau::CodeGen::AssemblyOptions options,
-    Luau::CodeGen::LoweringStats* stats
-) {
-    std::unique_ptr<lua_State, void (*)(lua_State*)> globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+// ============================================================================
+// Benchmark
+// ============================================================================
 
-    if (luau_load(L, name, bytecode.data(), bytecode.size(), 0) == 0)
-        return Luau::CodeGen::getAssembly(L, -1, options, stats);
+static const int kBenchmarkMaxIterations = 100000;
+static const int kBenchmarkTimeLimitMs = 60000;
 
-    return "Error loading bytecode";
-}
+struct BenchmarkLevel {
+    int optimizationLevel = 0;
+    std::string error;
+    double compileMs = 0.0;
+    std::vector<double> timesMs;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint32_t gcCycles = 0;
+};
 
-static void annotateInstruction(void* context, std::string& text, int fid, int instpos)
-{
-    Luau::BytecodeBuilder& bcb = *(Luau::BytecodeBuilder*)context;
+static std::string topErrorString(lua_State* L, const char* fallback) {
+    const char* msg = lua_tostring(L, -1);
+    return msg ? msg : fallback;
+}
 
-    bcb.annotateInstruction(text, fid, instpos);
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
 }
 
-/**
- * Add a module that can be required.
- * Call this before luau_execute to set up modules.
- */
-EXPORT void luau_add_module(const char* name, const char* source) {
-    g_modules[name] = source;
+// Compile once, then time repeated calls of the chunk (or functionName) on one run thread
+static void runBenchmarkLevel(lua_State* base, const std::string& source, const std::string& functionName,
+                              int iterations, int warmup, BenchmarkLevel& level) {
+    RunThread thread(base);
+    lua_State* L = thread.L;
+    
+    lua_pushcfunction(L, errorHandler, "errorHandler");
+    int errHandlerIdx = lua_gettop(L);
+    
+    // Compiled without coverage instrumentation, which would be timed too (see g_coverageRun)
+    Luau::CompileOptions options = executionCompileOptions();
+    options.optimizationLevel = level.optimizationLevel;
+    
+    // Compiled outside the bytecode cache, so compileMs is a real compile even on a rerun
+    double compileStart = nowMs();
+    std::string bytecode = compileTraced(source, options);
+    level.compileMs = nowMs() - compileStart;
+    
+    if (luau_load(L, "=main", bytecode.data(), bytecode.size(), 0) != 0) {
+        level.error = topErrorString(L, "Failed to load bytecode");
+        return;
+    }
+    
+    // A named function is looked up after one run of the chunk: in the table it returns, then in its globals
+    if (!functionName.empty()) {
+        if (lua_pcall(L, 0, 1, errHandlerIdx) != 0) {
+            level.error = topErrorString(L, "Unknown runtime error");
+            return;
+        }
+        if (lua_istable(L, -1)) {
+            lua_getfield(L, -1, functionName.c_str());
+            lua_remove(L, -2);
+        } else {
+            lua_pop(L, 1);
+            lua_pushnil(L);
+        }
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1);
+            lua_getglobal(L, functionName.c_str());
+        }
+        if (!lua_isfunction(L, -1)) {
+            level.error = "function '" + functionName + "' not found; return it from the chunk or make it global";
+            return;
+        }
+    }
+    int target = lua_gettop(L);
+    
+    // Every level starts from a collected heap
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    
+    uint32_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint32_t gcCycles = 0;
+    
+    level.timesMs.reserve(iterations);
+    for (int i = 0; i < warmup + iterations; i++) {
+        if (i == warmup) {
+            allocations = g_allocator.allocations;
+            allocatedBytes = g_allocator.allocatedBytes;
+            gcCycles = g_allocator.gcCycles;
+        }
+        
+        lua_pushvalue(L, target);
+        double start = nowMs();
+        int status = lua_pcall(L, 0, 0, errHandlerIdx);
+        double elapsed = nowMs() - start;
+        
+        if (status != 0) {
+            level.error = topErrorString(L, "Unknown runtime error");
+            return;
+        }
+        if (i >= warmup) {
+            level.timesMs.push_back(elapsed);
+        }
+    }
+    
+    level.allocations = g_allocator.allocations - allocations;
+    level.allocatedBytes = g_allocator.allocatedBytes - allocatedBytes;
+    level.gcCycles = g_allocator.gcCycles - gcCycles;
 }
 
-/**
- * Clear all modules.
- */
-EXPORT void luau_clear_modules() {
-    g_modules.clear();
+static void appendBenchmarkLevel(std::ostringstream& json, const BenchmarkLevel& level) {
+    json << "{\"optimizationLevel\":" << level.optimizationLevel;
+    json << ",\"success\":" << ::json::boolean(level.error.empty());
+    json << ",\"compileMs\":" << level.compileMs;
+    
+    if (!level.error.empty()) {
+        json << ",\"error\":" << ::json::string(level.error) << "}";
+        return;
+    }
+    
+    std::vector<double> sorted = level.timesMs;
+    std::sort(sorted.begin(), sorted.end());
+    
+    double n = static_cast<double>(sorted.size());
+    double mean = 0.0;
+    for (double t : sorted) mean += t;
+    mean /= n;
+    
+    double variance = 0.0;
+    for (double t : sorted) variance += (t - mean) * (t - mean);
+    variance = sorted.size() > 1 ? variance / (n - 1) : 0.0;
+    
+    json << ",\"minMs\":" << sorted.front();
+    json << ",\"maxMs\":" << sorted.back();
+    json << ",\"meanMs\":" << mean;
+    json << ",\"medianMs\":" << percentile(sorted, 0.5);
+    json << ",\"p95Ms\":" << percentile(sorted, 0.95);
+    json << ",\"stddevMs\":" << std::sqrt(variance);
+    json << ",\"allocationsPerIteration\":" << (level.allocations / n);
+    json << ",\"allocatedBytesPerIteration\":" << (level.allocatedBytes / n);
+    json << ",\"gcCyclesPerIteration\":" << (level.gcCycles / n);
+    json << "}";
 }
 
 /**
- * Get list of available modules for autocomplete.
- * Returns: { "modules": ["name1", "name2", ...] }
+ * Time repeated runs of a script with warmup.
+ * The chunk is compiled once per level and every call reuses one run thread; prints are discarded.
+ * @param iterations Measured runs (1..100000)
+ * @param warmup Unmeasured runs before them
+ * @param optimizationLevel 0-2, or -1 to compare levels 0, 1 and 2 in one call
+ * @param functionName Call this function instead of the chunk ("" = the chunk). It is looked up
+ *        after running the chunk once, in the table the chunk returns and then in its globals
+ * Returns: { "success": bool, "iterations", "warmup", "function": string?, "levels": [{ optimizationLevel,
+ *            success, compileMs, minMs, maxMs, meanMs, medianMs, p95Ms, stddevMs, allocationsPerIteration,
+ *            allocatedBytesPerIteration, gcCyclesPerIteration, error? }],
+ *            "comparison": [{ optimizationLevel, speedup }]? (median of the first level over each level's) }
  */
-EXPORT const char* luau_get_modules() {
+EXPORT const char* luau_benchmark(const char* code, int iterations, int warmup, int optimizationLevel, const char* functionName) {
+    TraceSpan span("luau_benchmark", "execute");
+    
+    iterations = std::clamp(iterations, 1, kBenchmarkMaxIterations);
+    warmup = std::clamp(warmup, 0, kBenchmarkMaxIterations);
+    std::string function = functionName ? functionName : "";
+    
+    lua_State* base = ensureBaseState();
+    if (!base) {
+        return setResult("{\"success\":false,\"error\":\"Failed to create Lua state\",\"levels\":[]}");
+    }
+    
+    g_budget = ExecutionBudget{};
+    g_budget.deadline = nowMs() + kBenchmarkTimeLimitMs;
+    g_allocator.beginRun();
+    
+    std::vector<BenchmarkLevel> levels;
+    if (optimizationLevel < 0) {
+        for (int level = 0; level <= 2; level++) levels.push_back(BenchmarkLevel{level});
+    } else {
+        levels.push_back(BenchmarkLevel{std::min(optimizationLevel, 2)});
+    }
+    
+    g_discardPrints = true;
+    for (BenchmarkLevel& level : levels) {
+        try {
+            runBenchmarkLevel(base, code, function, iterations, warmup, level);
+        } catch (const std::exception& e) {
+            level.error = std::string("C++ exception: ") + e.what();
+        }
+        
+        // Stops and exhausted budgets apply to the whole benchmark
+        if (g_budget.interruptReason) break;
+    }
+    g_discardPrints = false;
+    
+    bool success = true;
+    for (const BenchmarkLevel& level : levels) {
+        if (!level.error.empty() || level.timesMs.empty()) success = false;
+    }
+    
     std::ostringstream json;
-    json << "{\"modules\":[";
+    json << "{\"success\":" << ::json::boolean(success);
+    json << ",\"iterations\":" << iterations;
+    json << ",\"warmup\":" << warmup;
+    if (!function.empty()) {
+        json << ",\"function\":" << ::json::string(function);
+    }
+    if (g_budget.interruptReason) {
+        json << ",\"interrupted\":true";
+    }
     
-    bool first = true;
-    for (const auto& [name, _] : g_modules) {
-        // Skip the main file
-        if (name == "main" || name == "main.luau") continue;
+    json << ",\"levels\":[";
+    for (size_t i = 0; i < levels.size(); i++) {
+        if (i > 0) json << ",";
+        appendBenchmarkLevel(json, levels[i]);
+    }
+    json << "]";
+    
+    if (success && levels.size() > 1) {
+        auto median = [](const BenchmarkLevel& level) {
+            std::vector<double> sorted = level.timesMs;
+            std::sort(sorted.begin(), sorted.end());
+            return percentile(sorted, 0.5);
+        };
         
-        if (!first) json << ",";
-        first = false;
-        json << ::json::string(name);
+        double baseline = median(levels.front());
+        json << ",\"comparison\":[";
+        for (size_t i = 0; i < levels.size(); i++) {
+            if (i > 0) json << ",";
+            double levelMedian = median(levels[i]);
+            json << "{\"optimizationLevel\":" << levels[i].optimizationLevel;
+            json << ",\"speedup\":" << (levelMedian > 0.0 ? baseline / levelMedian : 0.0) << "}";
+        }
+        json << "]";
     }
     
-    json << "]}";
+    json << "}";
     return setResult(json.str());
 }
 
-static std::string buildPrintsJson() {
-    std::string prints = "[";
-    for (size_t i = 0; i < g_printCalls.size(); i++) {
-        if (i > 0) prints += ",";
-        prints += g_printCalls[i];
+#ifndef LUAU_PLAYGROUND_EXECUTION_ONLY
+
+// ============================================================================
+// Bytecode Dumps
+// ============================================================================
+
+// Dump formats, in the order of luau_dump_bytecode's outputFormat
+enum DumpFormat {
+    DumpFormat_Vm = 0,
+    DumpFormat_Ir = 1,
+    DumpFormat_X64 = 2,
+    DumpFormat_A64 = 3,
+    DumpFormat_Count
+};
+
+static const char* const kDumpFormatNames[DumpFormat_Count] = {"vm", "ir", "x64", "a64"};
+
+// luau_dump_all mask bit for lowering stats of the requested codegen formats
+static const int kDumpStatsBit = 1 << 4;
+
+// One compile per (source, optimization level, debug level, remarks) with its bytecode
+// loaded once for codegen. Formats are rendered on first request, so switching views
+// in the bytecode panel is a lookup. Entries hold a lua_State, so only a few are kept.
+static const size_t kDumpCacheCapacity = 4;
+
+struct CompiledDump {
+    std::string source;
+    int optimizationLevel = 0;
+    int debugLevel = 0;
+    int typeInfoLevel = 0;
+    std::string vectorLib;
+    std::string vectorCtor;
+    std::string vectorType;
+    bool showRemarks = false;
+    std::string error;                                  // compile error; nothing else is set then
+    std::unique_ptr<Luau::BytecodeBuilder> bytecode;    // also annotates codegen output
+    std::unique_ptr<lua_State, decltype(&lua_close)> state{nullptr, lua_close};    // main proto at the top
+    std::optional<std::string> formats[DumpFormat_Count];
+    std::optional<std::vector<CodegenFunction>> functions;
+    std::unordered_map<int, std::string> functionFormats[DumpFormat_Count];   // by function id
+    std::optional<std::string> stats[DumpFormat_Count];                     // lowering stats JSON (x64, a64)
+    uint64_t lastUse = 0;
+};
+
+static std::unordered_map<uint64_t, CompiledDump> g_dumpCache;
+static uint64_t g_dumpCacheClock = 0;
+
+static CompiledDump& compileDump(const std::string& source, const Luau::CompileOptions& options, bool showRemarks) {
+    uint64_t key = hashCompileInput(source, options) ^ (showRemarks ? 0x9e3779b97f4a7c15ull : 0);
+    
+    auto it = g_dumpCache.find(key);
+    if (it != g_dumpCache.end() && it->second.source == source && it->second.showRemarks == showRemarks &&
+        it->second.optimizationLevel == options.optimizationLevel && it->second.debugLevel == options.debugLevel &&
+        it->second.typeInfoLevel == options.typeInfoLevel && it->second.vectorLib == optionString(options.vectorLib) &&
+        it->second.vectorCtor == optionString(options.vectorCtor) && it->second.vectorType == optionString(options.vectorType)) {
+        it->second.lastUse = ++g_dumpCacheClock;
+        return it->second;
     }
-    prints += "]";
-    return prints;
+    
+    if (it != g_dumpCache.end()) {
+        g_dumpCache.erase(it);
+    } else if (g_dumpCache.size() >= kDumpCacheCapacity) {
+        auto oldest = g_dumpCache.begin();
+        for (auto entry = g_dumpCache.begin(); entry != g_dumpCache.end(); ++entry) {
+            if (entry->second.lastUse < oldest->second.lastUse) oldest = entry;
+        }
+        g_dumpCache.erase(oldest);
+    }
+    
+    CompiledDump& dump = g_dumpCache[key];
+    dump.source = source;
+    dump.optimizationLevel = options.optimizationLevel;
+    dump.debugLevel = options.debugLevel;
+    dump.typeInfoLevel = options.typeInfoLevel;
+    dump.vectorLib = optionString(options.vectorLib);
+    dump.vectorCtor = optionString(options.vectorCtor);
+    dump.vectorType = optionString(options.vectorType);
+    dump.showRemarks = showRemarks;
+    dump.lastUse = ++g_dumpCacheClock;
+    
+    uint32_t dumpFlags = Luau::BytecodeBuilder::Dump_Code | Luau::BytecodeBuilder::Dump_Lines;
+    if (options.debugLevel >= 2) {
+        dumpFlags |= Luau::BytecodeBuilder::Dump_Locals;
+    }
+    if (showRemarks) {
+        dumpFlags |= Luau::BytecodeBuilder::Dump_Remarks;
+    }
+    
+    dump.bytecode = std::make_unique<Luau::BytecodeBuilder>();
+    dump.bytecode->setDumpFlags(dumpFlags);
+    dump.bytecode->setDumpSource(dump.source);
+    
+    Luau::ParseOptions parseOptions;
+    parseOptions.captureComments = true;
+    
+    try {
+        Luau::compileOrThrow(*dump.bytecode, dump.source, options, parseOptions);
+    } catch (const std::exception& e) {
+        dump.error = e.what();
+        dump.bytecode.reset();
+        return dump;
+    }
+    
+    // Share the compiled chunk with execution (same key as compileCached)
+    storeCachedBytecode(dump.source, options, dump.bytecode->getBytecode());
+    return dump;
 }
 
-/**
- * Execute Luau code and return the output as JSON.
- * Returns: { "success": bool, "output": string, "prints": [[LuauValue]], "error": string? }
- */
-EXPORT const char* luau_execute(const char* code) {
-    g_outputBuffer.clear();
-    g_printCalls.clear();
+// Load the compiled chunk for codegen once; nullptr if it fails to load
+static lua_State* dumpState(CompiledDump& dump) {
+    if (!dump.state) {
+        dump.state.reset(luaL_newstate());
+        const std::string& bytecode = dump.bytecode->getBytecode();
+        if (luau_load(dump.state.get(), "main", bytecode.data(), bytecode.size(), 0) != 0) {
+            dump.state.reset();
+        }
+    }
+    return dump.state.get();
+}
+
+static Luau::CodeGen::AssemblyOptions dumpAssemblyOptions(CompiledDump& dump, DumpFormat format) {
+    Luau::CodeGen::AssemblyOptions asmOptions;
+    asmOptions.annotator = annotateInstruction;
+    asmOptions.annotatorContext = dump.bytecode.get();
+    // Use X64_SystemV for IR since we're in WASM (Host won't work)
+    asmOptions.target = format == DumpFormat_A64 ? Luau::CodeGen::AssemblyOptions::A64 : Luau::CodeGen::AssemblyOptions::X64_SystemV;
+    asmOptions.outputBinary = false;
+    asmOptions.includeAssembly = format != DumpFormat_Ir;
+    asmOptions.includeIr = true;
+    asmOptions.includeIrTypes = false;
+    asmOptions.includeOutlinedCode = false;
+    return asmOptions;
+}
+
+// Render one format of a successful compile
+static const std::string& renderDump(CompiledDump& dump, DumpFormat format) {
+    std::optional<std::string>& text = dump.formats[format];
+    if (text) return *text;
     
-    // Create a new Lua state
-    std::unique_ptr<lua_State, decltype(&lua_close)> L(luaL_newstate(), lua_close);
-    if (!L) {
-        return setResult("{\"success\":false,\"output\":\"\",\"prints\":[],\"error\":\"Failed to create Lua state\"}");
+    if (format == DumpFormat_Vm) {
+        text = dump.bytecode->dumpEverything();
+    } else if (lua_State* L = dumpState(dump)) {
+        text = getCodegenAssembly(L, dumpAssemblyOptions(dump, format), nullptr);
+    } else {
+        text = "Error loading bytecode";
+    }
+    return *text;
+}
+
+static const std::vector<CodegenFunction>& dumpFunctions(CompiledDump& dump) {
+    if (!dump.functions) {
+        lua_State* L = dumpState(dump);
+        dump.functions = L ? listCodegenFunctions(L) : std::vector<CodegenFunction>{};
+    }
+    return *dump.functions;
+}
+
+// Render one format for a single function; codegen lowers only that function
+static const std::string& renderFunctionDump(CompiledDump& dump, DumpFormat format, int functionId) {
+    auto it = dump.functionFormats[format].find(functionId);
+    if (it != dump.functionFormats[format].end()) return it->second;
+    
+    std::string text;
+    if (format == DumpFormat_Vm) {
+        // Same shape as dumpEverything's per-function section
+        for (const CodegenFunction& function : dumpFunctions(dump)) {
+            if (function.id != functionId) continue;
+            
+            text = "Function " + std::to_string(functionId) + " (" + (function.name.empty() ? "??" : function.name) + "):\n";
+            text += dump.bytecode->dumpFunction(static_cast<uint32_t>(functionId));
+            break;
+        }
+    } else if (lua_State* L = dumpState(dump)) {
+        text = getFunctionAssembly(L, functionId, dumpAssemblyOptions(dump, format), nullptr);
+    } else {
+        text = "Error loading bytecode";
     }
     
-    // Set up sandbox
-    registerPlaygroundGlobals(L.get());
+    return dump.functionFormats[format].emplace(functionId, std::move(text)).first->second;
+}
+
+// Lowering stats and bytecode summaries per function, as JSON. Each function is lowered
+// on its own (getFunctionAssembly) because LoweringStats sums spills and blocks over
+// everything lowered in one call. IR is lowered for x64, so "ir" and "x64" agree.
+static const std::string& renderDumpStats(CompiledDump& dump, DumpFormat format) {
+    if (format == DumpFormat_Ir) format = DumpFormat_X64;
     
-    // Push error handler FIRST (so it's at a fixed position)
-    lua_pushcfunction(L.get(), errorHandler, "errorHandler");
-    int errHandlerIdx = lua_gettop(L.get());  // Should be 1
+    std::optional<std::string>& json = dump.stats[format];
+    if (json) return *json;
     
-    // Compile the code
-    size_t bytecodeSize = 0;
-    char* bytecode = luau_compile(code, strlen(code), nullptr, &bytecodeSize);
+    unsigned instructionLimit = unsigned(FInt::CodegenHeuristicsInstructionLimit.value);
+    unsigned blockLimit = unsigned(FInt::CodegenHeuristicsBlockLimit.value);
+    unsigned blockInstructionLimit = unsigned(FInt::CodegenHeuristicsBlockInstructionLimit.value);
     
-    if (!bytecode) {
-        return setResult("{\"success\":false,\"output\":\"\",\"prints\":[],\"error\":\"Compilation failed\"}");
-    }
+    std::ostringstream out;
+    out << "{\"target\":\"" << (format == DumpFormat_A64 ? "a64" : "x64") << "\"";
+    out << ",\"limits\":{\"instructions\":" << instructionLimit;
+    out << ",\"blocks\":" << blockLimit;
+    out << ",\"blockInstructions\":" << blockInstructionLimit << "}";
     
-    // Load the bytecode (function goes on top of error handler)
-    int loadResult = luau_load(L.get(), "=main", bytecode, bytecodeSize, 0);
-    free(bytecode);
+    Luau::CodeGen::LoweringStats totals;
+    out << ",\"functions\":[";
     
-    if (loadResult != 0) {
-        const char* errMsg = lua_tostring(L.get(), -1);
-        std::string error = errMsg ? errMsg : "Failed to load bytecode";
-        std::ostringstream result;
-        result << "{\"success\":false,\"output\":" << json::string(g_outputBuffer);
-        result << ",\"prints\":" << buildPrintsJson();
-        result << ",\"error\":" << json::string(error) << "}";
-        return setResult(result.str());
+    lua_State* L = format == DumpFormat_Vm ? nullptr : dumpState(dump);
+    bool first = true;
+    for (const CodegenFunction& function : L ? dumpFunctions(dump) : std::vector<CodegenFunction>{}) {
+        Luau::CodeGen::LoweringStats stats;
+        stats.functionStatsFlags = Luau::CodeGen::FunctionStats_Enable | Luau::CodeGen::FunctionStats_BytecodeSummary;
+        
+        // Only the counts are wanted, so skip building text
+        Luau::CodeGen::AssemblyOptions options = dumpAssemblyOptions(dump, format);
+        options.includeAssembly = false;
+        options.includeIr = false;
+        getFunctionAssembly(L, function.id, options, &stats);
+        
+        totals.totalFunctions += stats.totalFunctions;
+        totals.skippedFunctions += stats.skippedFunctions;
+        totals.spillsToSlot += stats.spillsToSlot;
+        totals.spillsToRestore += stats.spillsToRestore;
+        totals.blocksPreOpt += stats.blocksPreOpt;
+        totals.blocksPostOpt += stats.blocksPostOpt;
+        totals.regAllocErrors += stats.regAllocErrors;
+        totals.loweringErrors += stats.loweringErrors;
+        
+        // Functions the chunk never lowers (e.g. cold ones) have no entry
+        if (stats.functions.empty()) continue;
+        const Luau::CodeGen::FunctionStats& fs = stats.functions.back();
+        
+        if (!first) out << ",";
+        first = false;
+        
+        out << "{\"id\":" << function.id;
+        out << ",\"name\":" << ::json::string(function.name);
+        out << ",\"line\":" << fs.line;
+        out << ",\"bytecodeInstructions\":" << fs.bcodeCount;
+        out << ",\"irInstructions\":" << fs.irCount;
+        out << ",\"asmInstructions\":" << fs.asmCount;
+        out << ",\"asmBytes\":" << fs.asmSize;
+        out << ",\"blocksPreOpt\":" << stats.blocksPreOpt;
+        out << ",\"blocksPostOpt\":" << stats.blocksPostOpt;
+        out << ",\"maxBlockInstructions\":" << stats.maxBlockInstructions;
+        out << ",\"spillsToSlot\":" << stats.spillsToSlot;
+        out << ",\"spillsToRestore\":" << stats.spillsToRestore;
+        out << ",\"maxSpillSlots\":" << stats.maxSpillSlotsUsed;
+        out << ",\"skipped\":" << (stats.skippedFunctions > 0 ? "true" : "false");
+        
+        // Which codegen heuristics limits this function reaches (lowering bails out at them)
+        out << ",\"limitsHit\":[";
+        bool firstLimit = true;
+        auto limit = [&](bool hit, const char* name) {
+            if (!hit) return;
+            if (!firstLimit) out << ",";
+            firstLimit = false;
+            out << "\"" << name << "\"";
+        };
+        limit(fs.irCount >= instructionLimit, "instructions");
+        limit(stats.blocksPreOpt >= blockLimit, "blocks");
+        limit(stats.maxBlockInstructions >= blockInstructionLimit, "blockInstructions");
+        out << "]";
+        
+        // Opcode counts indexed by LuauOpcode, one array per loop nesting depth
+        out << ",\"opcodes\":[";
+        for (size_t depth = 0; depth < fs.bytecodeSummary.size(); depth++) {
+            if (depth > 0) out << ",";
+            out << "[";
+            for (size_t op = 0; op < fs.bytecodeSummary[depth].size(); op++) {
+                if (op > 0) out << ",";
+                out << fs.bytecodeSummary[depth][op];
+            }
+            out << "]";
+        }
+        out << "]}";
     }
     
-    // Stack: [errorHandler, function]
-    // Execute with error handler at position 1
-    int callResult = 0;
-    try {
-        callResult = lua_pcall(L.get(), 0, 0, errHandlerIdx);
-    } catch (const std::exception& e) {
-        std::ostringstream result;
-        result << "{\"success\":false,\"output\":" << json::string(g_outputBuffer);
-        result << ",\"prints\":" << buildPrintsJson();
-        result << ",\"error\":" << json::string(std::string("C++ exception: ") + e.what()) << "}";
-        return setResult(result.str());
-    } catch (...) {
-        std::ostringstream result;
-        result << "{\"success\":false,\"output\":" << json::string(g_outputBuffer);
-        result << ",\"prints\":" << buildPrintsJson();
-        result << ",\"error\":\"Unknown C++ exception\"}";
-        return setResult(result.str());
-    }
-    
-    if (callResult != 0) {
-        const char* errMsg = lua_tostring(L.get(), -1);
-        std::string error = errMsg ? errMsg : "Unknown runtime error";
-        std::ostringstream result;
-        result << "{\"success\":false,\"output\":" << json::string(g_outputBuffer);
-        result << ",\"prints\":" << buildPrintsJson();
-        result << ",\"error\":" << json::string(error) << "}";
-        return setResult(result.str());
-    }
+    out << "],\"totals\":{\"functions\":" << totals.totalFunctions;
+    out << ",\"skipped\":" << totals.skippedFunctions;
+    out << ",\"spillsToSlot\":" << totals.spillsToSlot;
+    out << ",\"spillsToRestore\":" << totals.spillsToRestore;
+    out << ",\"blocksPreOpt\":" << totals.blocksPreOpt;
+    out << ",\"blocksPostOpt\":" << totals.blocksPostOpt;
+    out << ",\"regAllocErrors\":" << totals.regAllocErrors;
+    out << ",\"loweringErrors\":" << totals.loweringErrors;
+    out << "}}";
     
-    std::ostringstream result;
-    result << "{\"success\":true,\"output\":" << json::string(g_outputBuffer);
-    result << ",\"prints\":" << buildPrintsJson() << "}";
-    return setResult(result.str());
+    json = out.str();
+    return *json;
+}
+
+// Execution's options with the requested levels, so dumps show the code that runs
+// (without coverage instrumentation)
+static Luau::CompileOptions dumpCompileOptions(int optimizationLevel, int debugLevel) {
+    Luau::CompileOptions options = executionCompileOptions();
+    options.coverageLevel = 0;
+    options.optimizationLevel = std::max(0, std::min(2, optimizationLevel));
+    options.debugLevel = std::max(0, std::min(2, debugLevel));
+    return options;
 }
 
 /**
@@ -626,83 +3169,129 @@ EXPORT const char* luau_execute(const char* code) {
  */
 EXPORT const char* luau_dump_bytecode(const char* code, int optimizationLevel, int debugLevel, int outputFormat, bool showRemarks) {
     try {
-        Luau::CompileOptions options;
-        options.optimizationLevel = std::max(0, std::min(2, optimizationLevel));
-        options.debugLevel = std::max(0, std::min(2, debugLevel));
-        
-        // Set up dump flags
-        uint32_t dumpFlags = Luau::BytecodeBuilder::Dump_Code | Luau::BytecodeBuilder::Dump_Lines;
-        if (options.debugLevel >= 2) {
-            dumpFlags |= Luau::BytecodeBuilder::Dump_Locals;
+        CompiledDump& dump = compileDump(code, dumpCompileOptions(optimizationLevel, debugLevel), showRemarks);
+        if (!dump.error.empty()) {
+            return setResult("{\"success\":false,\"bytecode\":\"\",\"error\":" + json::string(dump.error) + "}");
         }
-        if (showRemarks) {
-            dumpFlags |= Luau::BytecodeBuilder::Dump_Remarks;
+        
+        std::string text;
+        if (outputFormat >= 0 && outputFormat < DumpFormat_Count) {
+            text = renderDump(dump, static_cast<DumpFormat>(outputFormat));
         }
+        return setResult("{\"success\":true,\"bytecode\":" + json::string(text) + "}");
+    } catch (const std::exception& e) {
+        return setResult("{\"success\":false,\"bytecode\":\"\",\"error\":" + json::string(e.what()) + "}");
+    }
+}
 
-        Luau::BytecodeBuilder bytecode;
-        bytecode.setDumpFlags(dumpFlags);
-        bytecode.setDumpSource(code);
+/**
+ * Dump several formats from one compile. The compile and every rendered format are
+ * cached per source, optimization level, debug level and remarks flag.
+ * @param formatMask Bit per format: 1 = VM, 2 = IR, 4 = x64, 8 = arm64; 16 adds lowering stats
+ *                   for each requested codegen format
+ * Returns: { "success": true, "formats": { "vm"?: string, "ir"?: string, "x64"?: string, "a64"?: string },
+ *            "stats"?: { "ir"?, "x64"?, "a64"?: { "target", "limits", "functions": [...], "totals" } } }
+ *       or { "success": false, "error": string }
+ */
+EXPORT const char* luau_dump_all(const char* code, int optimizationLevel, int debugLevel, int formatMask, bool showRemarks) {
+    try {
+        CompiledDump& dump = compileDump(code, dumpCompileOptions(optimizationLevel, debugLevel), showRemarks);
+        if (!dump.error.empty()) {
+            return setResult("{\"success\":false,\"error\":" + json::string(dump.error) + "}");
+        }
         
-        Luau::ParseOptions parseOptions;
-        parseOptions.captureComments = true;
+        std::string out = "{\"success\":true,\"formats\":{";
+        bool first = true;
+        for (int format = 0; format < DumpFormat_Count; format++) {
+            if (!(formatMask & (1 << format))) continue;
+            
+            if (!first) out += ",";
+            first = false;
+            out += "\"";
+            out += kDumpFormatNames[format];
+            out += "\":" + json::string(renderDump(dump, static_cast<DumpFormat>(format)));
+        }
+        out += "}";
         
-        Luau::compileOrThrow(bytecode, std::string(code), options, parseOptions);
+        if (formatMask & kDumpStatsBit) {
+            out += ",\"stats\":{";
+            bool firstStats = true;
+            for (int format = DumpFormat_Ir; format < DumpFormat_Count; format++) {
+                if (!(formatMask & (1 << format))) continue;
+                
+                if (!firstStats) out += ",";
+                firstStats = false;
+                out += "\"";
+                out += kDumpFormatNames[format];
+                out += "\":" + renderDumpStats(dump, static_cast<DumpFormat>(format));
+            }
+            out += "}";
+        }
         
-        Luau::CodeGen::AssemblyOptions asmOptions;
-        asmOptions.annotator = annotateInstruction;
-        asmOptions.annotatorContext = &bytecode;
-
-        std::string dump;
-
-        switch (outputFormat)
-        {
-        case 0:
-            dump = bytecode.dumpEverything();
-            break;
-        case 1:
-            // Use X64_SystemV for IR since we're in WASM (Host won't work)
-            asmOptions.target = Luau::CodeGen::AssemblyOptions::X64_SystemV;
-            asmOptions.outputBinary = false;
-            asmOptions.includeAssembly = false;
-            asmOptions.includeIr = true;
-            asmOptions.includeIrTypes = false;
-            asmOptions.includeOutlinedCode = false;
-            dump = getCodegenAssembly("main", bytecode.getBytecode(), asmOptions, nullptr);
-            break;
-        case 2:
-            asmOptions.target = Luau::CodeGen::AssemblyOptions::X64_SystemV;
-            asmOptions.outputBinary = false;
-            asmOptions.includeAssembly = true;
-            asmOptions.includeIr = true;
-            asmOptions.includeIrTypes = false;
-            asmOptions.includeOutlinedCode = false;
-            dump = getCodegenAssembly("main", bytecode.getBytecode(), asmOptions, nullptr);
-            break;
-        case 3:
-            asmOptions.target = Luau::CodeGen::AssemblyOptions::A64;
-            asmOptions.outputBinary = false;
-            asmOptions.includeAssembly = true;
-            asmOptions.includeIr = true;
-            asmOptions.includeIrTypes = false;
-            asmOptions.includeOutlinedCode = false;
-            dump = getCodegenAssembly("main", bytecode.getBytecode(), asmOptions, nullptr);
-            break;
+        out += "}";
+        return setResult(out);
+    } catch (const std::exception& e) {
+        return setResult("{\"success\":false,\"error\":" + json::string(e.what()) + "}");
+    }
+}
 
-        default:
-            break;
+/**
+ * List the functions of a chunk, for picking one to dump.
+ * Shares luau_dump_all's compile cache (same key arguments).
+ * Returns: { "success": true, "functions": [{ "id": number, "name": string, "main": bool,
+ *            "lineStart": number, "lineEnd": number, "instructionOffset": number, "instructions": number }] }
+ *       or { "success": false, "error": string }
+ * Lines are 1-based; without debug info (debugLevel 0) lineStart/lineEnd fall back to the line defined.
+ */
+EXPORT const char* luau_dump_functions(const char* code, int optimizationLevel, int debugLevel, bool showRemarks) {
+    try {
+        CompiledDump& dump = compileDump(code, dumpCompileOptions(optimizationLevel, debugLevel), showRemarks);
+        if (!dump.error.empty()) {
+            return setResult("{\"success\":false,\"error\":" + json::string(dump.error) + "}");
+        }
+        
+        std::ostringstream out;
+        out << "{\"success\":true,\"functions\":[";
+        bool first = true;
+        for (const CodegenFunction& function : dumpFunctions(dump)) {
+            if (!first) out << ",";
+            first = false;
+            
+            out << "{\"id\":" << function.id;
+            out << ",\"name\":" << json::string(function.name);
+            out << ",\"main\":" << (function.isMain ? "true" : "false");
+            out << ",\"lineStart\":" << function.lineStart;
+            out << ",\"lineEnd\":" << function.lineEnd;
+            out << ",\"instructionOffset\":" << function.instructionOffset;
+            out << ",\"instructions\":" << function.instructions;
+            out << "}";
         }
+        out << "]}";
+        return setResult(out.str());
+    } catch (const std::exception& e) {
+        return setResult("{\"success\":false,\"error\":" + json::string(e.what()) + "}");
+    }
+}
 
-        std::ostringstream result;
-        result << "{\"success\":true,\"bytecode\":" << json::string(dump) << "}";
-        return setResult(result.str());
-    } catch (const Luau::CompileError& e) {
-        std::ostringstream result;
-        result << "{\"success\":false,\"bytecode\":\"\",\"error\":" << json::string(e.what()) << "}";
-        return setResult(result.str());
+/**
+ * Dump one function (id from luau_dump_functions) in one format; codegen formats lower
+ * only that function. Results are cached with the compile.
+ * Returns: { "success": bool, "bytecode": string, "error": string? }
+ */
+EXPORT const char* luau_dump_function(const char* code, int optimizationLevel, int debugLevel, int outputFormat, int functionId, bool showRemarks) {
+    try {
+        CompiledDump& dump = compileDump(code, dumpCompileOptions(optimizationLevel, debugLevel), showRemarks);
+        if (!dump.error.empty()) {
+            return setResult("{\"success\":false,\"bytecode\":\"\",\"error\":" + json::string(dump.error) + "}");
+        }
+        
+        std::string text;
+        if (outputFormat >= 0 && outputFormat < DumpFormat_Count) {
+            text = renderFunctionDump(dump, static_cast<DumpFormat>(outputFormat), functionId);
+        }
+        return setResult("{\"success\":true,\"bytecode\":" + json::string(text) + "}");
     } catch (const std::exception& e) {
-        std::ostringstream result;
-        result << "{\"success\":false,\"bytecode\":\"\",\"error\":" << json::string(e.what()) << "}";
-        return setResult(result.str());
+        return setResult("{\"success\":false,\"bytecode\":\"\",\"error\":" + json::string(e.what()) + "}");
     }
 }
 
@@ -710,55 +3299,12 @@ EXPORT const char* luau_dump_bytecode(const char* code, int optimizationLevel, i
 // Analysis: Type Checking and IDE Features
 // ============================================================================
 
-// Simple multi-file resolver for the playground
+// Simple multi-file resolver for the playground, over the modules require also sees
 class PlaygroundFileResolver : public Luau::FileResolver {
 public:
-    std::unordered_map<std::string, std::string> sources;
-    
-    // Find a source with path normalization
-    std::pair<bool, std::string> findSource(const std::string& path) const {
-        std::string normalized = normalizeModulePath(path);
-        
-        // Try exact match
-        if (sources.count(normalized)) {
-            return {true, normalized};
-        }
-        
-        // Try with .luau extension
-        if (sources.count(normalized + ".luau")) {
-            return {true, normalized + ".luau"};
-        }
-        
-        // Try with .lua extension
-        if (sources.count(normalized + ".lua")) {
-            return {true, normalized + ".lua"};
-        }
-        
-        // Try without extension if it has one
-        size_t dotPos = normalized.rfind('.');
-        if (dotPos != std::string::npos) {
-            std::string withoutExt = normalized.substr(0, dotPos);
-            if (sources.count(withoutExt)) {
-                return {true, withoutExt};
-            }
-            if (sources.count(withoutExt + ".luau")) {
-                return {true, withoutExt + ".luau"};
-            }
-            if (sources.count(withoutExt + ".lua")) {
-                return {true, withoutExt + ".lua"};
-            }
-        }
-        
-        return {false, ""};
-    }
-    
     std::optional<Luau::SourceCode> readSource(const Luau::ModuleName& name) override {
-        auto [found, resolvedName] = findSource(name);
-        if (found) {
-            auto it = sources.find(resolvedName);
-            if (it != sources.end()) {
-                return Luau::SourceCode{it->second, Luau::SourceCode::Module};
-            }
+        if (const ModuleRegistry::Entry* module = g_moduleRegistry.find(name)) {
+            return Luau::SourceCode{module->second.source, Luau::SourceCode::Module};
         }
         return std::nullopt;
     }
@@ -769,11 +3315,8 @@ public:
         const Luau::TypeCheckLimits& limits
     ) override {
         if (auto* expr = node->as<Luau::AstExprConstantString>()) {
-            std::string path(expr->value.data, expr->value.size);
-            
-            auto [found, resolvedName] = findSource(path);
-            if (found) {
-                return Luau::ModuleInfo{resolvedName};
+            if (const ModuleRegistry::Entry* module = g_moduleRegistry.find(std::string_view(expr->value.data, expr->value.size))) {
+                return Luau::ModuleInfo{module->first};
             }
         }
         return std::nullopt;
@@ -805,9 +3348,21 @@ static std::unique_ptr<Luau::Frontend> g_frontend;
 static Luau::Mode g_mode = Luau::Mode::Nonstrict;
 static bool g_useNewSolver = true;
 
+// Cold start timings (ms), reported by luau_get_analysis_stats; -1 until measured
+struct AnalysisStartupStats {
+    double frontendMs = -1.0;
+    double globalsMs = -1.0;
+    double autocompleteGlobalsMs = -1.0;    // built on the first old-solver autocomplete
+};
+
+static AnalysisStartupStats g_startupStats;
+static bool g_autocompleteGlobalsReady = false;
+
 static void ensureAnalysisInit() {
     if (g_frontend) return;
     
+    double start = nowMs();
+    
     // Set feature flags for the new solver before any initialization
     FFlag::LuauSolverV2.value = g_useNewSolver;
     FFlag::LuauUseWorkspacePropToChooseSolver.value = true;
@@ -835,12 +3390,26 @@ static void ensureAnalysisInit() {
         g_frontend->useNewLuauSolver.store(Luau::SolverMode::Old);
     }
     
-    // Register built-in types
+    double frontendReady = nowMs();
+    g_startupStats.frontendMs = frontendReady - start;
+    
+    // Register built-in types; the autocomplete environment is deferred until it is needed
     Luau::registerBuiltinGlobals(*g_frontend, g_frontend->globals, false);
     Luau::freeze(g_frontend->globals.globalTypes);
     
+    g_startupStats.globalsMs = nowMs() - frontendReady;
+}
+
+// The old solver's forAutocomplete checks type against globalsForAutocomplete; diagnostics,
+// hover and the new solver never touch it, so it is only built for the first such check
+static void ensureAutocompleteGlobals() {
+    if (g_autocompleteGlobalsReady) return;
+    
+    double start = nowMs();
     Luau::registerBuiltinGlobals(*g_frontend, g_frontend->globalsForAutocomplete, true);
     Luau::freeze(g_frontend->globalsForAutocomplete.globalTypes);
+    g_autocompleteGlobalsReady = true;
+    g_startupStats.autocompleteGlobalsMs = nowMs() - start;
 }
 
 /**
@@ -868,90 +3437,562 @@ EXPORT void luau_set_mode(int mode) {
         g_configResolver->config.mode = g_mode;
     }
     
-    // Mark all files dirty to re-analyze with new mode
-    if (g_frontend && g_fileResolver) {
-        for (const auto& [name, _] : g_fileResolver->sources) {
-            g_frontend->markDirty(name);
-        }
-    }
+    // Mark all files dirty to re-analyze with new mode
+    if (g_frontend && g_fileResolver) {
+        for (const auto& [name, _] : g_moduleRegistry.all()) {
+            g_frontend->markDirty(name);
+        }
+    }
+}
+
+/**
+ * Set the solver mode.
+ * @param useNew true = New solver, false = Old solver
+ */
+EXPORT void luau_set_solver(bool useNew) {
+    g_useNewSolver = useNew;
+    
+    // Set feature flags for the new solver
+    // Both flags are needed: LuauSolverV2 enables the new solver globally,
+    // LuauUseWorkspacePropToChooseSolver allows per-frontend solver selection
+    FFlag::LuauSolverV2.value = useNew;
+    FFlag::LuauUseWorkspacePropToChooseSolver.value = true;
+    
+    // Reset frontend to apply new solver (solver mode is set at initialization)
+    if (g_frontend) {
+        if (g_useNewSolver) {
+            g_frontend->useNewLuauSolver.store(Luau::SolverMode::New);
+        } else {
+            g_frontend->useNewLuauSolver.store(Luau::SolverMode::Old);
+        }
+        
+        // Mark all files dirty to re-analyze with new solver
+        if (g_fileResolver) {
+            for (const auto& [name, _] : g_moduleRegistry.all()) {
+                g_frontend->markDirty(name);
+            }
+        }
+    }
+}
+
+// Store a source and invalidate it only when the text actually changed. The document
+// version (ModuleRegistry::Module::version) is bumped on every change, so queries can
+// name the exact text they were issued against instead of resubmitting it.
+// markDirty also dirties every module that (transitively) requires it, so the
+// next check only revisits the edited module and its dependents.
+static void setAnalysisSource(const std::string& name, const char* source) {
+    ModuleRegistry::Module& module = g_moduleRegistry.insert(name).second;
+    if (module.version > 0 && module.source == source) {
+        return;
+    }
+    
+    module.source = source;
+    g_frontend->markDirty(name);
+    module.version++;
+}
+
+// Current version of a document, 0 if it was never set for analysis
+static int documentVersion(const std::string& name) {
+    const ModuleRegistry::Entry* module = g_moduleRegistry.findExact(name);
+    return module ? module->second.version : 0;
+}
+
+// Byte offset of a (0-based) line/column in text, clamped to the line and text ends
+static size_t positionToOffset(const std::string& text, int line, int col) {
+    size_t offset = 0;
+    for (int i = 0; i < line; i++) {
+        size_t newline = text.find('\n', offset);
+        if (newline == std::string::npos) return text.size();
+        offset = newline + 1;
+    }
+    
+    size_t lineEnd = text.find('\n', offset);
+    if (lineEnd == std::string::npos) lineEnd = text.size();
+    return std::min(offset + static_cast<size_t>(std::max(0, col)), lineEnd);
+}
+
+// Resolve the document a query targets. Fails for unknown files and for versions
+// other than the current one (the host has edits in flight); version < 0 means "current".
+static bool resolveDocument(const char* name, int version, std::string& resolvedName) {
+    const ModuleRegistry::Entry* module = g_moduleRegistry.find(name);
+    if (!module || module->second.version == 0) return false;
+    
+    resolvedName = module->first;
+    return version < 0 || module->second.version == version;
+}
+
+/**
+ * Set source for a file (for multi-file analysis).
+ */
+EXPORT void luau_set_source(const char* name, const char* source) {
+    ensureAnalysisInit();
+    setAnalysisSource(name, source);
+}
+
+// One typecheck per document version, shared by diagnostics, hover and autocomplete.
+// Frontend::isDirty covers edits to required modules (markDirty propagates to
+// dependents), so a clean module at the same version is a pure lookup.
+struct CheckCacheEntry {
+    int version = -1;                   // version of the regular check
+    int autocompleteVersion = -1;       // version of the old solver's autocomplete pass
+    std::vector<Luau::TypeError> errors;    // this module's own errors
+};
+
+struct CheckCacheStats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t cancelled = 0;
+};
+
+static std::unordered_map<std::string, CheckCacheEntry> g_checkCache;
+static CheckCacheStats g_checkCacheStats;
+
+// Cancellation for the check in progress. Only a host sharing the wasm memory can set it
+// while a check runs (luau_analysis_cancel_flag); it is cleared when a query starts, so it
+// only aborts work that was already running. Elsewhere checks are bounded by the time limit.
+static std::shared_ptr<Luau::FrontendCancellationToken> g_cancellationToken =
+    std::make_shared<Luau::FrontendCancellationToken>();
+static std::optional<double> g_checkTimeLimitSec;
+static bool g_lastQueryCancelled = false;
+
+static void beginAnalysisQuery() {
+    g_cancellationToken->cancelled.store(false);
+    g_lastQueryCancelled = false;
+}
+
+static bool analysisCancelled() {
+    return g_cancellationToken->requested();
+}
+
+// The new solver serves autocomplete from the regular module graph; only the old
+// solver needs its separate forAutocomplete pass
+static bool needsAutocompleteCheck() {
+    return !g_useNewSolver;
+}
+
+// Memory-budgeted analysis (luau_set_analysis_memory_budget). The wasm heap never shrinks,
+// so with a budget set only the active document (the latest query target) keeps its full
+// type graph: modules it requires are checked without retainFullTypeGraphs, which leaves
+// just their exported interface, and once the type arenas pass the budget the least
+// recently queried modules outside the active document's require graph are dropped.
+static size_t g_memoryBudgetBytes = 0;      // 0 = keep every module's full graph
+static std::string g_activeDocument;
+static uint64_t g_documentUseClock = 0;
+static std::unordered_map<std::string, uint64_t> g_documentLastUse;
+static uint32_t g_evictedModules = 0;
+
+static size_t arenaBytes(const Luau::TypeArena& arena) {
+    return arena.types.size() * sizeof(Luau::Type) + arena.typePacks.size() * sizeof(Luau::TypePackVar);
+}
+
+static size_t moduleArenaBytes(const Luau::ModulePtr& module) {
+    return module ? arenaBytes(module->internalTypes) + arenaBytes(module->interfaceTypes) : 0;
+}
+
+// Frontend clears the AST type maps of modules checked without retainFullTypeGraphs
+static bool hasFullTypeGraph(const Luau::ModulePtr& module) {
+    return module && module->astTypes.size() > 0;
+}
+
+static size_t documentArenaBytes(const std::string& name) {
+    return moduleArenaBytes(g_frontend->moduleResolver.getModule(name)) +
+        moduleArenaBytes(g_frontend->moduleResolverForAutocomplete.getModule(name));
+}
+
+// Drop everything Frontend holds for a module and for the modules requiring it (their
+// types point into its arenas). markDirty makes the next check that needs them parse
+// and typecheck them again.
+static void evictModule(const std::string& name) {
+    std::vector<std::string> pending{name};
+    std::unordered_set<std::string> evicted;
+    
+    while (!pending.empty()) {
+        std::string current = std::move(pending.back());
+        pending.pop_back();
+        if (!evicted.insert(current).second) continue;
+        
+        for (const auto& [dependent, node] : g_frontend->sourceNodes) {
+            for (const auto& [required, _] : node->requireLocations) {
+                if (required == current) {
+                    pending.push_back(dependent);
+                    break;
+                }
+            }
+        }
+    }
+    
+    for (const std::string& module : evicted) {
+        g_frontend->markDirty(module);
+        g_frontend->moduleResolver.setModule(module, nullptr);
+        g_frontend->moduleResolverForAutocomplete.setModule(module, nullptr);
+        g_frontend->sourceModules.erase(module);
+        g_checkCache.erase(module);
+        g_evictedModules++;
+    }
+}
+
+// The active document and everything it (transitively) requires
+static std::unordered_set<std::string> activeModuleGraph() {
+    std::unordered_set<std::string> graph;
+    std::vector<std::string> pending{g_activeDocument};
+    
+    while (!pending.empty()) {
+        std::string name = std::move(pending.back());
+        pending.pop_back();
+        if (!graph.insert(name).second) continue;
+        
+        auto it = g_frontend->sourceNodes.find(name);
+        if (it == g_frontend->sourceNodes.end()) continue;
+        for (const auto& [required, _] : it->second->requireLocations) {
+            pending.push_back(required);
+        }
+    }
+    
+    return graph;
+}
+
+// Reduce a checked module to what a check without retainFullTypeGraphs keeps, as Frontend
+// does after such a check: errors are copied into the interface arena, then the internal
+// arena and AST type maps are released. Modules requiring it only reference its interface,
+// so they stay valid and clean.
+static void dropFullTypeGraph(const Luau::ModulePtr& module, std::vector<Luau::TypeError>* cachedErrors) {
+    Luau::unfreeze(module->interfaceTypes);
+    Luau::copyErrors(module->errors, module->interfaceTypes, g_frontend->builtinTypes);
+    if (cachedErrors) Luau::copyErrors(*cachedErrors, module->interfaceTypes, g_frontend->builtinTypes);
+    Luau::freeze(module->interfaceTypes);
+    
+    module->internalTypes.clear();
+    module->astTypes.clear();
+    module->astTypePacks.clear();
+    module->astExpectedTypes.clear();
+    module->astOriginalCallTypes.clear();
+    module->astOverloadResolvedTypes.clear();
+    module->astResolvedTypes.clear();
+    module->astResolvedTypePacks.clear();
+    module->astScopes.clear();
+    module->scopes.resize(1);
+}
+
+// Called before a query targets `name`. The previous active document keeps only its
+// interface (dropFullTypeGraph) without being rechecked, and neither do the modules
+// requiring it; it is checked in full again if it becomes active again. Modules are only
+// evicted by enforceMemoryBudget.
+static void activateDocument(const std::string& name) {
+    g_documentLastUse[name] = ++g_documentUseClock;
+    if (name == g_activeDocument) return;
+    
+    std::string previous = std::exchange(g_activeDocument, name);
+    if (g_memoryBudgetBytes == 0 || previous.empty()) return;
+    
+    // Cached diagnostics point into the internal arena too. Completion and signature
+    // caches are dropped by their own checks (hasFullTypeGraph, a new module on recheck).
+    Luau::ModulePtr module = g_frontend->moduleResolver.getModule(previous);
+    if (hasFullTypeGraph(module)) {
+        auto entry = g_checkCache.find(previous);
+        dropFullTypeGraph(module, entry != g_checkCache.end() ? &entry->second.errors : nullptr);
+    }
+    
+    Luau::ModulePtr autocompleteModule = g_frontend->moduleResolverForAutocomplete.getModule(previous);
+    if (hasFullTypeGraph(autocompleteModule)) {
+        dropFullTypeGraph(autocompleteModule, nullptr);
+    }
+}
+
+static size_t analysisArenaBytes() {
+    size_t total = 0;
+    for (const auto& [name, _] : g_frontend->sourceNodes) {
+        total += documentArenaBytes(name);
+    }
+    return total;
+}
+
+// Evict least recently queried modules until the type arenas fit the budget
+static void enforceMemoryBudget() {
+    if (g_memoryBudgetBytes == 0) return;
+    
+    size_t total = analysisArenaBytes();
+    if (total <= g_memoryBudgetBytes) return;
+    
+    // Modules never queried directly (only required) count as the oldest
+    std::unordered_set<std::string> pinned = activeModuleGraph();
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (const auto& [name, _] : g_frontend->sourceNodes) {
+        if (pinned.count(name)) continue;
+        auto it = g_documentLastUse.find(name);
+        candidates.emplace_back(it != g_documentLastUse.end() ? it->second : 0, name);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    
+    for (const auto& [_, name] : candidates) {
+        if (total <= g_memoryBudgetBytes) break;
+        // Already gone as a dependent of an earlier eviction
+        if (documentArenaBytes(name) == 0) continue;
+        
+        evictModule(name);
+        total = analysisArenaBytes();
+    }
+}
+
+// Returns nullptr when the check was cancelled; nothing is cached for it then
+static const CheckCacheEntry* checkDocument(const std::string& name, bool forAutocomplete = false) {
+    TraceSpan span("check", "analysis");
+    span.arg("module", name);
+    
+    activateDocument(name);
+    
+    int version = documentVersion(name);
+    CheckCacheEntry& entry = g_checkCache[name];
+    
+    bool autocompletePass = forAutocomplete && needsAutocompleteCheck();
+    if (autocompletePass) {
+        ensureAutocompleteGlobals();
+    }
+    
+    // Under a memory budget, a module checked for its interface only (required by an
+    // earlier active document, or downgraded by activateDocument) is checked in full again
+    auto& resolver = autocompletePass ? g_frontend->moduleResolverForAutocomplete : g_frontend->moduleResolver;
+    Luau::ModulePtr checked = resolver.getModule(name);
+    if (g_memoryBudgetBytes > 0 && checked && !hasFullTypeGraph(checked)) {
+        g_frontend->markDirty(name);
+    }
+    
+    int& checkedVersion = autocompletePass ? entry.autocompleteVersion : entry.version;
+    if (checkedVersion == version && !g_frontend->isDirty(name, autocompletePass)) {
+        g_checkCacheStats.hits++;
+        span.arg("cached", true);
+        return &entry;
+    }
+    span.arg("cached", false);
+    
+    g_checkCacheStats.misses++;
+    
+    // Required modules this check revisits get new errors too; drop their cached ones
+    for (auto& [cached, cachedEntry] : g_checkCache) {
+        if (cached != name && g_frontend->isDirty(cached, autocompletePass)) {
+            (autocompletePass ? cachedEntry.autocompleteVersion : cachedEntry.version) = -1;
+        }
+    }
+    
+    // Lint results are not reported, so skip them; full type graphs are kept for hover
+    Luau::FrontendOptions opts;
+    opts.retainFullTypeGraphs = true;
+    opts.runLintChecks = false;
+    opts.forAutocomplete = autocompletePass;
+    opts.cancellationToken = g_cancellationToken;
+    opts.moduleTimeLimitSec = g_checkTimeLimitSec;
+    
+    // Under a memory budget, check the required modules first for their interface only,
+    // so the full check below finds them clean and retains just this module's graph
+    if (g_memoryBudgetBytes > 0) {
+        g_frontend->parse(name);
+        
+        Luau::FrontendOptions interfaceOpts = opts;
+        interfaceOpts.retainFullTypeGraphs = false;
+        auto node = g_frontend->sourceNodes.find(name);
+        if (node != g_frontend->sourceNodes.end()) {
+            for (const auto& [required, _] : node->second->requireLocations) {
+                if (!analysisCancelled() && g_frontend->isDirty(required, autocompletePass)) {
+                    g_frontend->check(required, interfaceOpts);
+                }
+            }
+        }
+    }
+    
+    Luau::CheckResult result = g_frontend->check(name, opts);
+    
+    if (analysisCancelled()) {
+        // Partially checked modules must not be reused
+        g_frontend->markDirty(name);
+        g_checkCacheStats.cancelled++;
+        g_lastQueryCancelled = true;
+        return nullptr;
+    }
+    
+    // Diagnostics come from the regular check only
+    if (!autocompletePass) {
+        entry.errors.clear();
+        for (auto& error : result.errors) {
+            // The result also carries errors from required modules; keep only this one's
+            if (error.moduleName == name) {
+                entry.errors.push_back(std::move(error));
+            }
+        }
+    }
+    
+    checkedVersion = version;
+    enforceMemoryBudget();
+    return &entry;
+}
+
+// Check a module and serialize its own diagnostics; Frontend::check rechecks only
+// dirty modules in its require graph and reuses results for the rest
+static const char* diagnosticsResult(const Luau::ModuleName& name) {
+    std::vector<const Luau::TypeError*> errors;
+    if (const CheckCacheEntry* entry = checkDocument(name)) {
+        for (const auto& error : entry->errors) {
+            errors.push_back(&error);
+        }
+    }
+    
+    TraceSpan span("buildResult", "analysis");
+    
+    // Binary record: u8 severity (0 = error), str message, i32 startLine, startCol, endLine, endCol
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        BinaryResultWriter writer(BinaryResultKind::Diagnostics);
+        for (const Luau::TypeError* error : errors) {
+            writer.beginRecord();
+            writer.u8(0);
+            writer.str(Luau::toString(*error));
+            writer.i32(static_cast<int32_t>(error->location.begin.line));
+            writer.i32(static_cast<int32_t>(error->location.begin.column));
+            writer.i32(static_cast<int32_t>(error->location.end.line));
+            writer.i32(static_cast<int32_t>(error->location.end.column));
+            writer.endRecord();
+        }
+        return writer.finish();
+    }
+    
+    std::ostringstream json;
+    json << "{\"diagnostics\":[";
+    
+    bool first = true;
+    for (const Luau::TypeError* error : errors) {
+        if (!first) json << ",";
+        first = false;
+        
+        json << "{";
+        json << "\"severity\":\"error\",";
+        json << "\"message\":" << ::json::string(Luau::toString(*error)) << ",";
+        json << "\"startLine\":" << error->location.begin.line << ",";
+        json << "\"startCol\":" << error->location.begin.column << ",";
+        json << "\"endLine\":" << error->location.end.line << ",";
+        json << "\"endCol\":" << error->location.end.column;
+        json << "}";
+    }
+    
+    json << "]}";
+    return setResult(json.str());
 }
 
 /**
- * Set the solver mode.
- * @param useNew true = New solver, false = Old solver
+ * Current version of a document, 0 if it was never set.
  */
-EXPORT void luau_set_solver(bool useNew) {
-    g_useNewSolver = useNew;
+EXPORT int luau_document_version(const char* name) {
+    return documentVersion(name);
+}
+
+/**
+ * Replace a range of a document set with luau_set_source (0-based lines, byte columns).
+ * Returns the new document version, or -1 if the document is unknown.
+ */
+EXPORT int luau_apply_edit(const char* name, int startLine, int startCol, int endLine, int endCol, const char* text) {
+    ensureAnalysisInit();
     
-    // Set feature flags for the new solver
-    // Both flags are needed: LuauSolverV2 enables the new solver globally,
-    // LuauUseWorkspacePropToChooseSolver allows per-frontend solver selection
-    FFlag::LuauSolverV2.value = useNew;
-    FFlag::LuauUseWorkspacePropToChooseSolver.value = true;
+    ModuleRegistry::Entry* module = g_moduleRegistry.findExact(name);
+    if (!module || module->second.version == 0) {
+        return -1;
+    }
     
-    // Reset frontend to apply new solver (solver mode is set at initialization)
+    std::string& source = module->second.source;
+    size_t start = positionToOffset(source, startLine, startCol);
+    size_t end = std::max(start, positionToOffset(source, endLine, endCol));
+    source.replace(start, end - start, text);
+    
+    g_frontend->markDirty(module->first);
+    return ++module->second.version;
+}
+
+/**
+ * Shared check cache counters and cold start timings since startup.
+ * Returns: { "checkHits": number, "checkMisses": number, "checkCancelled": number,
+ *            "startup": { "frontendMs", "globalsMs", "autocompleteGlobalsMs" } }
+ */
+EXPORT const char* luau_get_analysis_stats() {
+    std::ostringstream json;
+    json << "{\"checkHits\":" << g_checkCacheStats.hits;
+    json << ",\"checkMisses\":" << g_checkCacheStats.misses;
+    json << ",\"checkCancelled\":" << g_checkCacheStats.cancelled;
+    json << ",\"startup\":{";
+    json << "\"frontendMs\":" << g_startupStats.frontendMs;
+    json << ",\"globalsMs\":" << g_startupStats.globalsMs;
+    json << ",\"autocompleteGlobalsMs\":" << g_startupStats.autocompleteGlobalsMs;
+    json << "}}";
+    return setResult(json.str());
+}
+
+/**
+ * Bound the memory analysis keeps for inactive modules (see enforceMemoryBudget).
+ * @param budgetBytes Type arena budget; 0 = keep full type graphs for every module (default)
+ */
+EXPORT void luau_set_analysis_memory_budget(int budgetBytes) {
+    g_memoryBudgetBytes = static_cast<size_t>(std::max(0, budgetBytes));
     if (g_frontend) {
-        if (g_useNewSolver) {
-            g_frontend->useNewLuauSolver.store(Luau::SolverMode::New);
-        } else {
-            g_frontend->useNewLuauSolver.store(Luau::SolverMode::Old);
-        }
-        
-        // Mark all files dirty to re-analyze with new solver
-        if (g_fileResolver) {
-            for (const auto& [name, _] : g_fileResolver->sources) {
-                g_frontend->markDirty(name);
-            }
-        }
+        enforceMemoryBudget();
     }
 }
 
 /**
- * Set source for a file (for multi-file analysis).
+ * Forget a document set with luau_set_source, releasing everything analysis holds for it.
+ * Modules requiring it are rechecked (and report the missing module) on their next query.
  */
-EXPORT void luau_set_source(const char* name, const char* source) {
+EXPORT void luau_close_document(const char* name) {
     ensureAnalysisInit();
-    g_fileResolver->sources[name] = source;
-    g_frontend->markDirty(name);
     
-    // Also add to modules for require
-    g_modules[name] = source;
+    std::string moduleName = name;
+    if (!g_moduleRegistry.erase(moduleName)) return;
+    
+    evictModule(moduleName);
+    g_frontend->sourceNodes.erase(moduleName);
+    g_documentLastUse.erase(moduleName);
+    if (g_activeDocument == moduleName) {
+        g_activeDocument.clear();
+    }
 }
 
 /**
- * Get diagnostics (type errors and lint warnings) for code.
- * Returns: { "diagnostics": [...] }
+ * Analysis memory: type arena sizes per module and the wasm heap.
+ * Returns: { "heapBytes": number, "heapUsedBytes": number, "budgetBytes": number,
+ *            "arenaBytes": number, "evictedModules": number, "activeDocument": string,
+ *            "modules": [{ "name", "fullTypeGraph", "internalTypes", "internalTypePacks",
+ *                          "interfaceTypes", "interfaceTypePacks", "bytes" }] }
+ * Module counts are from the regular check; "bytes" also covers the autocomplete pass.
  */
-EXPORT const char* luau_get_diagnostics(const char* code) {
+EXPORT const char* luau_memory_stats() {
     ensureAnalysisInit();
     
-    g_fileResolver->sources["main"] = code;
-    g_frontend->markDirty("main");
-    
-    // Check all dependency modules first so their types are available
-    for (const auto& [name, _] : g_fileResolver->sources) {
-        if (name != "main") {
-            g_frontend->check(name);
-        }
-    }
-    
-    Luau::CheckResult result = g_frontend->check("main");
+#ifdef __EMSCRIPTEN__
+    size_t heapBytes = emscripten_get_heap_size();
+    size_t heapUsedBytes = mallinfo().uordblks;
+#else
+    size_t heapBytes = 0;
+    size_t heapUsedBytes = 0;
+#endif
     
     std::ostringstream json;
-    json << "{\"diagnostics\":[";
+    json << "{\"heapBytes\":" << heapBytes;
+    json << ",\"heapUsedBytes\":" << heapUsedBytes;
+    json << ",\"budgetBytes\":" << g_memoryBudgetBytes;
+    json << ",\"arenaBytes\":" << analysisArenaBytes();
+    json << ",\"evictedModules\":" << g_evictedModules;
+    json << ",\"activeDocument\":" << ::json::string(g_activeDocument);
+    json << ",\"modules\":[";
     
     bool first = true;
-    for (const auto& error : result.errors) {
+    for (const auto& [name, _] : g_frontend->sourceNodes) {
+        Luau::ModulePtr module = g_frontend->moduleResolver.getModule(name);
+        size_t bytes = documentArenaBytes(name);
+        if (!module && bytes == 0) continue;
+        
         if (!first) json << ",";
         first = false;
         
-        json << "{";
-        json << "\"severity\":\"error\",";
-        json << "\"message\":" << ::json::string(Luau::toString(error)) << ",";
-        json << "\"startLine\":" << error.location.begin.line << ",";
-        json << "\"startCol\":" << error.location.begin.column << ",";
-        json << "\"endLine\":" << error.location.end.line << ",";
-        json << "\"endCol\":" << error.location.end.column;
+        json << "{\"name\":" << ::json::string(name);
+        json << ",\"fullTypeGraph\":" << (hasFullTypeGraph(module) ? "true" : "false");
+        json << ",\"internalTypes\":" << (module ? module->internalTypes.types.size() : 0);
+        json << ",\"internalTypePacks\":" << (module ? module->internalTypes.typePacks.size() : 0);
+        json << ",\"interfaceTypes\":" << (module ? module->interfaceTypes.types.size() : 0);
+        json << ",\"interfaceTypePacks\":" << (module ? module->interfaceTypes.typePacks.size() : 0);
+        json << ",\"bytes\":" << bytes;
         json << "}";
     }
     
@@ -960,56 +4001,241 @@ EXPORT const char* luau_get_diagnostics(const char* code) {
 }
 
 /**
- * Get autocomplete suggestions at position.
+ * Build the analysis environment now instead of on the first query, so an idle
+ * worker can absorb the cold start. Returns the time taken in ms.
+ */
+EXPORT double luau_init_analysis() {
+    double start = nowMs();
+    ensureAnalysisInit();
+    return nowMs() - start;
+}
+
+/**
+ * Whether the last diagnostics/autocomplete/hover query was cancelled (its result is empty).
+ */
+EXPORT bool luau_analysis_cancelled() {
+    return g_lastQueryCancelled;
+}
+
+/**
+ * Address of the cancellation flag (one byte, non-zero = cancel), for hosts that share
+ * the wasm memory and can set it with Atomics while the worker is busy. The running
+ * check stops and its query returns an empty result.
+ */
+EXPORT uintptr_t luau_analysis_cancel_flag() {
+    return reinterpret_cast<uintptr_t>(&g_cancellationToken->cancelled);
+}
+
+/**
+ * Set the time budget per module check; modules past it are reported with a timeout error.
+ * @param timeLimitMs 0 = unlimited
+ */
+EXPORT void luau_set_check_time_limit(int timeLimitMs) {
+    if (timeLimitMs > 0) {
+        g_checkTimeLimitSec = timeLimitMs / 1000.0;
+    } else {
+        g_checkTimeLimitSec.reset();
+    }
+}
+
+// Result for a query against an unknown or stale document
+static const char* emptyQueryResult(BinaryResultKind kind, const char* json) {
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        return BinaryResultWriter(kind).finish();
+    }
+    return setResult(json);
+}
+
+/**
+ * Get diagnostics (type errors and lint warnings) for a document.
+ * @param version Document version the request was issued against (-1 = current)
+ * Returns: { "diagnostics": [...] }, empty for unknown or stale documents
+ */
+EXPORT const char* luau_get_diagnostics(const char* name, int version) {
+    TraceSpan span("luau_get_diagnostics", "analysis");
+    ensureAnalysisInit();
+    beginAnalysisQuery();
+    
+    std::string moduleName;
+    if (!resolveDocument(name, version, moduleName)) {
+        return emptyQueryResult(BinaryResultKind::Diagnostics, "{\"diagnostics\":[]}");
+    }
+    
+    return diagnosticsResult(moduleName);
+}
+
+// Completion kind names; binary results store the index
+static const char* const kCompletionKinds[] = {
+    "variable", "property", "keyword", "constant", "type", "module", "function",
+};
+
+static int completionKind(const Luau::AutocompleteEntry& entry) {
+    if (entry.type && Luau::get<Luau::FunctionType>(Luau::follow(*entry.type))) {
+        return 6;
+    }
+    
+    switch (entry.kind) {
+        case Luau::AutocompleteEntryKind::Property: return 1;
+        case Luau::AutocompleteEntryKind::Keyword: return 2;
+        case Luau::AutocompleteEntryKind::String: return 3;
+        case Luau::AutocompleteEntryKind::Type: return 4;
+        case Luau::AutocompleteEntryKind::Module: return 5;
+        default: return 0;
+    }
+}
+
+static char asciiLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// How a label matches the typed prefix: 0 prefix, 1 prefix ignoring case, 2 the prefix's
+// characters in order from the first one (ignoring case), -1 no match
+static int completionMatchTier(const std::string& label, std::string_view prefix) {
+    if (prefix.empty()) return 0;
+    if (label.size() < prefix.size() || asciiLower(label[0]) != asciiLower(prefix[0])) return -1;
+    
+    if (label.compare(0, prefix.size(), prefix.data(), prefix.size()) == 0) return 0;
+    
+    bool prefixIgnoringCase = true;
+    for (size_t i = 0; i < prefix.size(); i++) {
+        if (asciiLower(label[i]) != asciiLower(prefix[i])) {
+            prefixIgnoringCase = false;
+            break;
+        }
+    }
+    if (prefixIgnoringCase) return 1;
+    
+    size_t matched = 0;
+    for (size_t i = 0; i < label.size() && matched < prefix.size(); i++) {
+        if (asciiLower(label[i]) == asciiLower(prefix[matched])) matched++;
+    }
+    return matched == prefix.size() ? 2 : -1;
+}
+
+struct CompletionMatch {
+    const std::string* label;
+    const Luau::AutocompleteEntry* entry;
+    int tier;
+};
+
+// Best first: closer prefix match, then type-correct entries, valid index types and
+// non-deprecated ones, then shorter and alphabetically first labels
+static bool betterCompletion(const CompletionMatch& a, const CompletionMatch& b) {
+    if (a.tier != b.tier) return a.tier < b.tier;
+    
+    bool aCorrect = a.entry->typeCorrect != Luau::TypeCorrectKind::None;
+    bool bCorrect = b.entry->typeCorrect != Luau::TypeCorrectKind::None;
+    if (aCorrect != bCorrect) return aCorrect;
+    if (a.entry->wrongIndexType != b.entry->wrongIndexType) return !a.entry->wrongIndexType;
+    if (a.entry->deprecated != b.entry->deprecated) return !a.entry->deprecated;
+    if (a.label->size() != b.label->size()) return a.label->size() < b.label->size();
+    return *a.label < *b.label;
+}
+
+// Entries of the last luau_autocomplete, for luau_autocomplete_resolve. Their types stay
+// valid while the checked module does: same version, not dirty, not replaced, and still
+// holding its full type graph (see dropFullTypeGraph).
+struct CompletionCache {
+    std::string moduleName;
+    int version = -1;
+    bool autocompletePass = false;
+    std::weak_ptr<Luau::Module> module;
+    Luau::AutocompleteEntryMap entries;
+};
+
+static CompletionCache g_completionCache;
+
+static Luau::ModulePtr completionModule(const std::string& moduleName, bool autocompletePass) {
+    auto& resolver = autocompletePass ? g_frontend->moduleResolverForAutocomplete : g_frontend->moduleResolver;
+    return resolver.getModule(moduleName);
+}
+
+/**
+ * Get autocomplete suggestions at position in a document, filtered by the typed prefix
+ * and ranked (see betterCompletion). Only returned items have their type stringified.
+ * @param prefix Identifier characters before the cursor ("" for all entries)
+ * @param limit Most items to return; <= 0 = no limit. A full page means more may match,
+ *              so hosts should query again as the prefix grows instead of filtering it
  * Returns: { "items": [...] }
  */
-EXPORT const char* luau_autocomplete(const char* code, int line, int col) {
+EXPORT const char* luau_autocomplete(const char* name, int version, int line, int col, const char* prefix, int limit) {
+    TraceSpan span("luau_autocomplete", "analysis");
     ensureAnalysisInit();
+    beginAnalysisQuery();
     
-    g_fileResolver->sources["main"] = code;
-    g_frontend->markDirty("main");
+    std::string moduleName;
+    if (!resolveDocument(name, version, moduleName)) {
+        return emptyQueryResult(BinaryResultKind::Autocomplete, "{\"items\":[]}");
+    }
     
-    Luau::FrontendOptions opts;
-    opts.retainFullTypeGraphs = true;
-    opts.forAutocomplete = true;
-    opts.runLintChecks = false;
-    g_frontend->check("main", opts);
+    if (!checkDocument(moduleName, /* forAutocomplete */ true)) {
+        return emptyQueryResult(BinaryResultKind::Autocomplete, "{\"items\":[]}");
+    }
     
     Luau::Position position{static_cast<unsigned int>(line), static_cast<unsigned int>(col)};
-    Luau::AutocompleteResult result = Luau::autocomplete(*g_frontend, "main", position, nullptr);
+    Luau::AutocompleteResult result = [&] {
+        TraceSpan lookupSpan("autocomplete", "analysis");
+        return Luau::autocomplete(*g_frontend, moduleName, position, nullptr);
+    }();
+    
+    TraceSpan buildSpan("buildResult", "analysis");
+    buildSpan.arg("entries", static_cast<double>(result.entryMap.size()));
+    
+    std::string_view typed = prefix ? prefix : "";
+    std::vector<CompletionMatch> matches;
+    matches.reserve(result.entryMap.size());
+    for (const auto& [label, entry] : result.entryMap) {
+        int tier = completionMatchTier(label, typed);
+        if (tier >= 0) {
+            matches.push_back({&label, &entry, tier});
+        }
+    }
+    
+    size_t count = limit > 0 ? std::min(matches.size(), static_cast<size_t>(limit)) : matches.size();
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), betterCompletion);
+    matches.resize(count);
+    buildSpan.arg("items", static_cast<double>(count));
+    
+    // Kept for luau_autocomplete_resolve; moving the map leaves the match pointers valid
+    bool autocompletePass = needsAutocompleteCheck();
+    g_completionCache = {moduleName, documentVersion(moduleName), autocompletePass,
+        completionModule(moduleName, autocompletePass), std::move(result.entryMap)};
+    
+    // Binary record: str label, u8 kind (index into kCompletionKinds), str detail (or none), u8 deprecated
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        BinaryResultWriter writer(BinaryResultKind::Autocomplete);
+        for (const CompletionMatch& match : matches) {
+            writer.beginRecord();
+            writer.str(*match.label);
+            writer.u8(static_cast<uint8_t>(completionKind(*match.entry)));
+            if (match.entry->type) {
+                writer.str(Luau::toString(*match.entry->type));
+            } else {
+                writer.noString();
+            }
+            writer.u8(match.entry->deprecated ? 1 : 0);
+            writer.endRecord();
+        }
+        return writer.finish();
+    }
     
     std::ostringstream json;
     json << "{\"items\":[";
     
     bool first = true;
-    for (const auto& [name, entry] : result.entryMap) {
+    for (const CompletionMatch& match : matches) {
         if (!first) json << ",";
         first = false;
         
-        // Determine kind
-        std::string kind = "variable";
-        switch (entry.kind) {
-            case Luau::AutocompleteEntryKind::Property: kind = "property"; break;
-            case Luau::AutocompleteEntryKind::Keyword: kind = "keyword"; break;
-            case Luau::AutocompleteEntryKind::String: kind = "constant"; break;
-            case Luau::AutocompleteEntryKind::Type: kind = "type"; break;
-            case Luau::AutocompleteEntryKind::Module: kind = "module"; break;
-            default: break;
-        }
-        
-        if (entry.type && Luau::get<Luau::FunctionType>(Luau::follow(*entry.type))) {
-            kind = "function";
-        }
-        
         json << "{";
-        json << "\"label\":" << ::json::string(name) << ",";
-        json << "\"kind\":" << ::json::string(kind);
+        json << "\"label\":" << ::json::string(*match.label) << ",";
+        json << "\"kind\":" << ::json::string(kCompletionKinds[completionKind(*match.entry)]);
         
-        if (entry.type) {
-            json << ",\"detail\":" << ::json::string(Luau::toString(*entry.type));
+        if (match.entry->type) {
+            json << ",\"detail\":" << ::json::string(Luau::toString(*match.entry->type));
         }
         
-        json << ",\"deprecated\":" << ::json::boolean(entry.deprecated);
+        json << ",\"deprecated\":" << ::json::boolean(match.entry->deprecated);
         json << "}";
     }
     
@@ -1018,32 +4244,107 @@ EXPORT const char* luau_autocomplete(const char* code, int line, int col) {
 }
 
 /**
- * Get hover information at position.
+ * Full details of an item from the last luau_autocomplete, like LSP completionItem/resolve:
+ * the complete (untruncated) type and a hover-style documentation block. Always returns JSON.
+ * Returns: { "item": { "label", "kind", "detail"?, "documentation"?, "deprecated" } | null },
+ *          null once the document changed since that list or for unknown labels
+ */
+EXPORT const char* luau_autocomplete_resolve(const char* label) {
+    ensureAnalysisInit();
+    
+    const char* empty = "{\"item\":null}";
+    
+    CompletionCache& cache = g_completionCache;
+    if (cache.moduleName.empty() || documentVersion(cache.moduleName) != cache.version ||
+        g_frontend->isDirty(cache.moduleName, cache.autocompletePass)) {
+        return setResult(empty);
+    }
+    
+    Luau::ModulePtr module = cache.module.lock();
+    if (!module || module != completionModule(cache.moduleName, cache.autocompletePass) || !hasFullTypeGraph(module)) {
+        return setResult(empty);
+    }
+    
+    auto it = cache.entries.find(label);
+    if (it == cache.entries.end()) {
+        return setResult(empty);
+    }
+    
+    const Luau::AutocompleteEntry& entry = it->second;
+    
+    std::ostringstream json;
+    json << "{\"item\":{";
+    json << "\"label\":" << ::json::string(it->first);
+    json << ",\"kind\":" << ::json::string(kCompletionKinds[completionKind(entry)]);
+    
+    if (entry.type) {
+        std::string type = Luau::toString(*entry.type, Luau::ToStringOptions{true});
+        json << ",\"detail\":" << ::json::string(type);
+        json << ",\"documentation\":" << ::json::string("```luau\n" + it->first + ": " + type + "\n```");
+    }
+    
+    json << ",\"deprecated\":" << ::json::boolean(entry.deprecated);
+    json << "}}";
+    return setResult(json.str());
+}
+
+// Build the luau_hover result; binary record: str content (or none)
+static const char* setHoverResult(const std::string* content) {
+    TraceSpan span("buildResult", "analysis");
+    
+    if (g_resultEncoding == ResultEncoding::Binary) {
+        BinaryResultWriter writer(BinaryResultKind::Hover);
+        writer.beginRecord();
+        if (content) {
+            writer.str(*content);
+        } else {
+            writer.noString();
+        }
+        writer.endRecord();
+        return writer.finish();
+    }
+    
+    if (!content) {
+        return setResult("{\"content\":null}");
+    }
+    
+    std::ostringstream json;
+    json << "{\"content\":" << ::json::string(*content) << "}";
+    return setResult(json.str());
+}
+
+/**
+ * Get hover information at position in a document.
  * Returns: { "content": string | null }
  */
-EXPORT const char* luau_hover(const char* code, int line, int col) {
+EXPORT const char* luau_hover(const char* name, int version, int line, int col) {
+    TraceSpan span("luau_hover", "analysis");
     ensureAnalysisInit();
+    beginAnalysisQuery();
     
-    g_fileResolver->sources["main"] = code;
-    g_frontend->markDirty("main");
+    std::string moduleName;
+    if (!resolveDocument(name, version, moduleName)) {
+        return setHoverResult(nullptr);
+    }
     
-    Luau::FrontendOptions opts;
-    opts.retainFullTypeGraphs = true;
-    opts.runLintChecks = false;
-    g_frontend->check("main", opts);
+    if (!checkDocument(moduleName)) {
+        return setHoverResult(nullptr);
+    }
     
-    Luau::SourceModule* sourceModule = g_frontend->getSourceModule("main");
+    Luau::SourceModule* sourceModule = g_frontend->getSourceModule(moduleName);
     
     // Resolve the checked module regardless of solver/forAutocomplete mode.
     // Prefer moduleResolver, then fall back to moduleResolverForAutocomplete.
-    Luau::ModulePtr module = g_frontend->moduleResolver.getModule("main");
+    Luau::ModulePtr module = g_frontend->moduleResolver.getModule(moduleName);
     if (!module)
-        module = g_frontend->moduleResolverForAutocomplete.getModule("main");
+        module = g_frontend->moduleResolverForAutocomplete.getModule(moduleName);
     
     if (!sourceModule || !module) {
-        return setResult("{\"content\":null}");
+        return setHoverResult(nullptr);
     }
     
+    TraceSpan lookupSpan("hover", "analysis");
+    
     Luau::Position position{static_cast<unsigned int>(line), static_cast<unsigned int>(col)};
     Luau::ExprOrLocal exprOrLocal = Luau::findExprOrLocalAtPosition(*sourceModule, position);
     
@@ -1092,8 +4393,10 @@ EXPORT const char* luau_hover(const char* code, int line, int col) {
         }
     }
     
+    lookupSpan.end();
+    
     if (typeStr.empty()) {
-        return setResult("{\"content\":null}");
+        return setHoverResult(nullptr);
     }
     
     std::string markdown = "```luau\n";
@@ -1102,16 +4405,218 @@ EXPORT const char* luau_hover(const char* code, int line, int col) {
     }
     markdown += typeStr + "\n```";
     
-    std::ostringstream json;
-    json << "{\"content\":" << ::json::string(markdown) << "}";
-    return setResult(json.str());
+    return setHoverResult(&markdown);
+}
+
+// One overload of a callee, formatted without its name (aliases of a function share
+// a type, so the name is prefixed per call)
+struct SignatureInfo {
+    std::vector<std::string> parameters;
+    std::string returns;                // ": T", empty for functions returning nothing
+    bool variadic = false;
+};
+
+// Formatted signatures per callee type: signature help fires on every '(' and ',', and
+// typing through an argument list only moves the active parameter. TypeIds are only
+// meaningful for the check that produced them, so the cache follows the module.
+struct SignatureCacheEntry {
+    int version = -1;
+    std::weak_ptr<Luau::Module> module;
+    std::map<std::pair<Luau::TypeId, bool>, std::vector<SignatureInfo>> signatures;   // (callee, self call)
+};
+
+static std::unordered_map<std::string, SignatureCacheEntry> g_signatureCache;
+
+static SignatureInfo formatSignature(const Luau::FunctionType* function, bool selfCall) {
+    SignatureInfo info;
+    
+    auto [argTypes, tail] = Luau::flatten(function->argTypes);
+    // A method call supplies self itself
+    size_t first = selfCall && !argTypes.empty() ? 1 : 0;
+    for (size_t i = first; i < argTypes.size(); i++) {
+        std::string parameter;
+        if (i < function->argNames.size() && function->argNames[i]) {
+            parameter = function->argNames[i]->name + ": ";
+        }
+        parameter += Luau::toString(argTypes[i]);
+        info.parameters.push_back(std::move(parameter));
+    }
+    
+    if (tail) {
+        if (auto variadic = Luau::get<Luau::VariadicTypePack>(Luau::follow(*tail))) {
+            info.parameters.push_back("...: " + Luau::toString(variadic->ty));
+        } else {
+            // Generic packs print as "T..."
+            info.parameters.push_back(Luau::toString(*tail));
+        }
+        info.variadic = true;
+    }
+    
+    auto [retTypes, retTail] = Luau::flatten(function->retTypes);
+    if (!retTypes.empty() || retTail) {
+        info.returns = ": " + Luau::toString(function->retTypes);
+    }
+    
+    return info;
+}
+
+// Function types a call can resolve to: one, or each function part of an intersection
+static std::vector<const Luau::FunctionType*> calleeOverloads(Luau::TypeId callee) {
+    callee = Luau::follow(callee);
+    if (auto function = Luau::get<Luau::FunctionType>(callee)) {
+        return {function};
+    }
+    
+    std::vector<const Luau::FunctionType*> overloads;
+    if (auto intersection = Luau::get<Luau::IntersectionType>(callee)) {
+        for (Luau::TypeId part : intersection->parts) {
+            if (auto function = Luau::get<Luau::FunctionType>(Luau::follow(part))) {
+                overloads.push_back(function);
+            }
+        }
+    }
+    return overloads;
+}
+
+static std::string calleeName(const Luau::AstExpr* func) {
+    if (auto global = func->as<Luau::AstExprGlobal>()) return global->name.value;
+    if (auto local = func->as<Luau::AstExprLocal>()) return local->local->name.value;
+    if (auto index = func->as<Luau::AstExprIndexName>()) return index->index.value;
+    return "";
+}
+
+// Innermost call whose argument list contains the position. Unclosed calls (the
+// editor is still typing them) extend to the end of what was parsed.
+static Luau::AstExprCall* findCallAtPosition(const Luau::SourceModule& sourceModule, const std::string& text, Luau::Position position) {
+    std::vector<Luau::AstNode*> ancestry = Luau::findAstAncestryOfPosition(sourceModule, position);
+    
+    for (auto it = ancestry.rbegin(); it != ancestry.rend(); ++it) {
+        auto call = (*it)->as<Luau::AstExprCall>();
+        if (!call || !(call->argLocation.begin < position)) continue;
+        
+        const Luau::Position& end = call->argLocation.end;
+        size_t endOffset = positionToOffset(text, end.line, end.column);
+        bool closed = endOffset > 0 && text[endOffset - 1] == ')';
+        if (position < end || (position == end && !closed)) {
+            return call;
+        }
+    }
+    
+    return nullptr;
+}
+
+// Index of the argument being typed: the first one not yet ended, or the next one
+// once a comma follows the last argument
+static size_t activeArgument(const Luau::AstExprCall* call, const std::string& text, Luau::Position position) {
+    for (size_t i = 0; i < call->args.size; i++) {
+        if (position <= call->args.data[i]->location.end) {
+            return i;
+        }
+    }
+    
+    if (call->args.size == 0) return 0;
+    
+    const Luau::Position& lastEnd = call->args.data[call->args.size - 1]->location.end;
+    size_t from = positionToOffset(text, lastEnd.line, lastEnd.column);
+    size_t to = positionToOffset(text, position.line, position.column);
+    size_t comma = text.find(',', from);
+    return comma != std::string::npos && comma < to ? call->args.size : call->args.size - 1;
 }
 
 /**
  * Get signature help at position.
- * Returns: { "signatures": [...] }
+ * @param version Document version the request was issued against (-1 = current)
+ * Returns: { "signatures": [{ "label": string, "parameters": [{ "label": string }] }],
+ *            "activeSignature": number, "activeParameter": number }
+ * Always JSON; overloads come from intersections of function types.
  */
-EXPORT const char* luau_signature_help(const char* code, int line, int col) {
-    // Simplified implementation - return empty for now
-    return setResult("{\"signatures\":[]}");
+EXPORT const char* luau_signature_help(const char* name, int version, int line, int col) {
+    TraceSpan span("luau_signature_help", "analysis");
+    ensureAnalysisInit();
+    beginAnalysisQuery();
+    
+    const char* empty = "{\"signatures\":[],\"activeSignature\":0,\"activeParameter\":0}";
+    
+    std::string moduleName;
+    if (!resolveDocument(name, version, moduleName) || !checkDocument(moduleName)) {
+        return setResult(empty);
+    }
+    
+    Luau::SourceModule* sourceModule = g_frontend->getSourceModule(moduleName);
+    Luau::ModulePtr module = g_frontend->moduleResolver.getModule(moduleName);
+    if (!sourceModule || !module) {
+        return setResult(empty);
+    }
+    
+    const std::string& text = g_moduleRegistry.findExact(moduleName)->second.source;
+    Luau::Position position{static_cast<unsigned int>(line), static_cast<unsigned int>(col)};
+    Luau::AstExprCall* call = findCallAtPosition(*sourceModule, text, position);
+    if (!call) {
+        return setResult(empty);
+    }
+    
+    // The type before overload resolution keeps every overload of an intersection
+    const Luau::TypeId* callee = module->astOriginalCallTypes.find(call->func);
+    if (!callee) callee = module->astTypes.find(call->func);
+    if (!callee) {
+        return setResult(empty);
+    }
+    
+    SignatureCacheEntry& cache = g_signatureCache[moduleName];
+    if (cache.version != documentVersion(moduleName) || cache.module.lock() != module) {
+        cache.version = documentVersion(moduleName);
+        cache.module = module;
+        cache.signatures.clear();
+    }
+    
+    auto key = std::make_pair(*callee, call->self);
+    auto cached = cache.signatures.find(key);
+    if (cached == cache.signatures.end()) {
+        std::vector<SignatureInfo> signatures;
+        for (const Luau::FunctionType* function : calleeOverloads(*callee)) {
+            signatures.push_back(formatSignature(function, call->self));
+        }
+        cached = cache.signatures.emplace(key, std::move(signatures)).first;
+    }
+    
+    const std::vector<SignatureInfo>& signatures = cached->second;
+    size_t activeParameter = activeArgument(call, text, position);
+    
+    // The first overload that takes that many arguments
+    size_t activeSignature = 0;
+    for (size_t i = 0; i < signatures.size(); i++) {
+        if (signatures[i].variadic || activeParameter < signatures[i].parameters.size()) {
+            activeSignature = i;
+            break;
+        }
+    }
+    
+    std::string prefix = calleeName(call->func);
+    
+    std::ostringstream json;
+    json << "{\"signatures\":[";
+    for (size_t i = 0; i < signatures.size(); i++) {
+        const SignatureInfo& signature = signatures[i];
+        if (i > 0) json << ",";
+        
+        std::string label = prefix + "(";
+        for (size_t p = 0; p < signature.parameters.size(); p++) {
+            if (p > 0) label += ", ";
+            label += signature.parameters[p];
+        }
+        label += ")" + signature.returns;
+        
+        json << "{\"label\":" << ::json::string(label) << ",\"parameters\":[";
+        for (size_t p = 0; p < signature.parameters.size(); p++) {
+            if (p > 0) json << ",";
+            json << "{\"label\":" << ::json::string(signature.parameters[p]) << "}";
+        }
+        json << "]}";
+    }
+    json << "],\"activeSignature\":" << activeSignature;
+    json << ",\"activeParameter\":" << activeParameter << "}";
+    
+    return setResult(json.str());
 }
+
+#endif // LUAU_PLAYGROUND_EXECUTION_ONLY